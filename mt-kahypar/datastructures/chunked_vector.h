@@ -0,0 +1,176 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "mt-kahypar/macros.h"
+
+namespace mt_kahypar {
+namespace ds {
+
+/**
+ * Array with a fixed logical size whose memory is allocated in chunks on the
+ * first write to a chunk. Chunks can be allocated concurrently, which allows
+ * parallel writers to grow the used prefix of the array without reserving
+ * memory for its full logical size in advance.
+ * Reading an entry requires that the write to it happens before the read,
+ * e.g., by publishing its position with release/acquire semantics.
+ */
+template<typename T, size_t LOG_CHUNK_SIZE = 14>
+class ChunkedVector {
+  static constexpr size_t CHUNK_SIZE = UL(1) << LOG_CHUNK_SIZE;
+  static constexpr size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+ public:
+  using value_type = T;
+
+  explicit ChunkedVector(const size_t size = 0) :
+    _size(0),
+    _num_chunks(0),
+    _chunks(nullptr),
+    _num_allocated_chunks(0) {
+    resize(size);
+  }
+
+  ChunkedVector(const ChunkedVector&) = delete;
+  ChunkedVector & operator= (const ChunkedVector &) = delete;
+
+  ChunkedVector(ChunkedVector&& other) :
+    ChunkedVector() {
+    swap(other);
+  }
+
+  ChunkedVector & operator= (ChunkedVector&& other) {
+    swap(other);
+    return *this;
+  }
+
+  ~ChunkedVector() {
+    for ( size_t i = 0; i < _num_chunks; ++i ) {
+      delete[] _chunks[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  size_t size() const {
+    return _size;
+  }
+
+  // ! Changes the logical size. Chunks beyond the new size are freed.
+  // ! Not thread-safe.
+  void resize(const size_t size) {
+    const size_t num_chunks = ( size + CHUNK_MASK ) >> LOG_CHUNK_SIZE;
+    if ( num_chunks != _num_chunks ) {
+      std::unique_ptr<std::atomic<T*>[]> chunks =
+        num_chunks > 0 ? std::make_unique<std::atomic<T*>[]>(num_chunks) : nullptr;
+      for ( size_t i = 0; i < num_chunks; ++i ) {
+        chunks[i].store(i < _num_chunks ? _chunks[i].load(std::memory_order_relaxed) : nullptr,
+                        std::memory_order_relaxed);
+      }
+      for ( size_t i = num_chunks; i < _num_chunks; ++i ) {
+        T* chunk = _chunks[i].load(std::memory_order_relaxed);
+        if ( chunk ) {
+          delete[] chunk;
+          --_num_allocated_chunks;
+        }
+      }
+      _chunks = std::move(chunks);
+      _num_chunks = num_chunks;
+    }
+    _size = size;
+  }
+
+  // ! Stores the value at position i and allocates the chunk containing i, if necessary.
+  // ! Can be called concurrently for different positions.
+  void set(const size_t i, const T& value) {
+    chunk(i)[i & CHUNK_MASK] = value;
+  }
+
+  // ! Chunks are loaded with acquire semantics, since other threads may
+  // ! publish new chunks concurrently (see chunk(i)).
+  T& operator[] (const size_t i) {
+    ASSERT(isAllocated(i));
+    return _chunks[i >> LOG_CHUNK_SIZE].load(std::memory_order_acquire)[i & CHUNK_MASK];
+  }
+
+  const T& operator[] (const size_t i) const {
+    ASSERT(isAllocated(i));
+    return _chunks[i >> LOG_CHUNK_SIZE].load(std::memory_order_acquire)[i & CHUNK_MASK];
+  }
+
+  bool isAllocated(const size_t i) const {
+    return i < _size && _chunks[i >> LOG_CHUNK_SIZE].load(std::memory_order_acquire) != nullptr;
+  }
+
+  size_t size_in_bytes() const {
+    return _num_allocated_chunks.load(std::memory_order_relaxed) * CHUNK_SIZE * sizeof(T) +
+      _num_chunks * sizeof(std::atomic<T*>);
+  }
+
+  void swap(ChunkedVector& other) {
+    std::swap(_size, other._size);
+    std::swap(_num_chunks, other._num_chunks);
+    std::swap(_chunks, other._chunks);
+    const size_t num_allocated_chunks = _num_allocated_chunks.load(std::memory_order_relaxed);
+    _num_allocated_chunks.store(other._num_allocated_chunks.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+    other._num_allocated_chunks.store(num_allocated_chunks, std::memory_order_relaxed);
+  }
+
+ private:
+  T* chunk(const size_t i) {
+    ASSERT(i < _size);
+    std::atomic<T*>& chunk = _chunks[i >> LOG_CHUNK_SIZE];
+    T* ptr = chunk.load(std::memory_order_acquire);
+    if ( ptr == nullptr ) {
+      T* new_chunk = new T[CHUNK_SIZE];
+      if ( chunk.compare_exchange_strong(ptr, new_chunk, std::memory_order_acq_rel) ) {
+        ptr = new_chunk;
+        _num_allocated_chunks.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        // another thread allocated the chunk in the meantime
+        delete[] new_chunk;
+      }
+    }
+    return ptr;
+  }
+
+  size_t _size;
+  size_t _num_chunks;
+  std::unique_ptr<std::atomic<T*>[]> _chunks;
+  std::atomic<size_t> _num_allocated_chunks;
+};
+
+template<typename T, size_t LOG_CHUNK_SIZE>
+void swap(ChunkedVector<T, LOG_CHUNK_SIZE>& lhs, ChunkedVector<T, LOG_CHUNK_SIZE>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace ds
+}  // namespace mt_kahypar
@@ -592,6 +592,10 @@ private:
       return changeNodePartImpl<false>(u, from, to, max_weight_to,
         report_success, my_delta_func, NOOP_NOTIFY_FUNC);
     } else {
+      if ( !gain_cache.requiresNotificationBeforeUpdate() ) {
+        return changeNodePartImpl<false>(u, from, to, max_weight_to,
+          report_success, my_delta_func, NOOP_NOTIFY_FUNC);
+      }
       return changeNodePartImpl<true>(u, from, to, max_weight_to,
         report_success, my_delta_func, [&](SynchronizedEdgeUpdate& sync_update) {
           gain_cache.notifyBeforeDeltaGainUpdate(*this, sync_update);
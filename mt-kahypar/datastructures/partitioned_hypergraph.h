@@ -631,6 +631,9 @@ class PartitionedHypergraph {
     if constexpr ( !GainCache::requires_notification_before_update ) {
       return changeNodePart(u, from, to, max_weight_to, report_success, my_delta_func);
     } else {
+      if ( !gain_cache.requiresNotificationBeforeUpdate() ) {
+        return changeNodePart(u, from, to, max_weight_to, report_success, my_delta_func);
+      }
       return changeNodePart(u, from, to, max_weight_to, report_success, my_delta_func,
         [&](SynchronizedEdgeUpdate& sync_update) {
           sync_update.pin_count_in_from_part_after = pinCountInPart(sync_update.he, from) - 1;
@@ -337,6 +337,25 @@ namespace mt_kahypar {
              po::value<size_t>((!initial_partitioning ? &context.refinement.min_border_vertices_per_thread :
                                 &context.initial_partitioning.refinement.min_border_vertices_per_thread))->value_name("<size_t>")->default_value(0),
              "Minimum number of border vertices per thread with which we perform a localized search (n-Level Partitioner).")
+            (( initial_partitioning ? "i-r-gain-cache-large-he-threshold" : "r-gain-cache-large-he-threshold"),
+             po::value<HypernodeID>((!initial_partitioning ? &context.refinement.gain_cache_large_he_threshold :
+                                &context.initial_partitioning.refinement.gain_cache_large_he_threshold))->value_name(
+                     "<uint32_t>")->default_value(std::numeric_limits<HypernodeID>::max()),
+             "Hyperedges with a size larger than this threshold are excluded from the cached gain terms.\n"
+             "Their contribution is computed on demand from their pin counts (only supported by the km1 gain cache).")
+            (( initial_partitioning ? "i-r-lazy-gain-cache-initialization" : "r-lazy-gain-cache-initialization"),
+             po::value<bool>((!initial_partitioning ? &context.refinement.lazy_gain_cache_initialization :
+                                &context.initial_partitioning.refinement.lazy_gain_cache_initialization))->value_name(
+                     "<bool>")->default_value(false),
+             "If true, the benefit terms of interior nodes are only materialized when they are modified for the first time\n"
+             "(only supported by the km1 gain cache).")
+            (( initial_partitioning ? "i-r-gain-cache-track-adjacent-blocks" : "r-gain-cache-track-adjacent-blocks"),
+             po::value<bool>((!initial_partitioning ? &context.refinement.gain_cache_track_adjacent_blocks :
+                                &context.initial_partitioning.refinement.gain_cache_track_adjacent_blocks))->value_name(
+                     "<bool>")->default_value(false),
+             "If true, the gain cache tracks the adjacent blocks of each node such that searching for the best target\n"
+             "block only visits adjacent blocks instead of all k blocks (only supported by the km1 gain cache).\n"
+             "Cannot be combined with r-gain-cache-large-he-threshold.")
             ((initial_partitioning ? "i-r-lp-type" : "r-lp-type"),
              po::value<std::string>()->value_name("<string>")->notifier(
                      [&, initial_partitioning](const std::string& type) {
@@ -351,6 +370,7 @@ namespace mt_kahypar {
              "Label Propagation Algorithm:\n"
              "- label_propagation\n"
              "- deterministic\n"
+             "- jet\n"
              "- do_nothing")
             ((initial_partitioning ? "i-r-lp-maximum-iterations" : "r-lp-maximum-iterations"),
              po::value<size_t>((!initial_partitioning ? &context.refinement.label_propagation.maximum_iterations :
@@ -362,6 +382,11 @@ namespace mt_kahypar {
                                 &context.initial_partitioning.refinement.deterministic_refinement.num_sub_rounds_sync_lp))->value_name(
                      "<size_t>")->default_value(5),
              "Number of sub-rounds for deterministic synchronous label propagation")
+            ((initial_partitioning ? "i-r-deterministic-fm-sub-rounds" : "r-deterministic-fm-sub-rounds"),
+             po::value<size_t>((!initial_partitioning ? &context.refinement.deterministic_refinement.num_sub_rounds_fm :
+                                &context.initial_partitioning.refinement.deterministic_refinement.num_sub_rounds_fm))->value_name(
+                     "<size_t>")->default_value(4),
+             "Number of sub-rounds for deterministic FM (the seed nodes of a round are split into sub-rounds)")
             ((initial_partitioning ? "i-r-sync-lp-active-nodeset" : "r-sync-lp-active-nodeset"),
              po::value<bool>((!initial_partitioning ? &context.refinement.deterministic_refinement.use_active_node_set :
                                 &context.initial_partitioning.refinement.deterministic_refinement.use_active_node_set))->value_name(
@@ -389,6 +414,42 @@ namespace mt_kahypar {
                                 &context.initial_partitioning.refinement.label_propagation.relative_improvement_threshold))->value_name(
                      "<double>")->default_value(-1.0),
              "Relative improvement threshold for label propagation.")
+            ((initial_partitioning ? "i-r-lp-use-gain-buckets" : "r-lp-use-gain-buckets"),
+             po::value<bool>((!initial_partitioning ? &context.refinement.label_propagation.use_gain_buckets :
+                              &context.initial_partitioning.refinement.label_propagation.use_gain_buckets))->value_name(
+                     "<bool>")->default_value(false),
+             "If true, label propagation orders the active nodes of a round into buckets by their best gain in the gain cache\n"
+             "(highest gains first) and skips nodes that cannot improve the solution (requires an initialized gain cache).")
+            ((initial_partitioning ? "i-r-lp-he-size-gain-threshold" : "r-lp-he-size-gain-threshold"),
+             po::value<size_t>((!initial_partitioning ? &context.refinement.label_propagation.hyperedge_size_gain_threshold :
+                                &context.initial_partitioning.refinement.label_propagation.hyperedge_size_gain_threshold))->value_name(
+                     "<size_t>")->default_value(std::numeric_limits<size_t>::max()),
+             "LP gain computation does not scan the connectivity set of hyperedges larger than this threshold that\n"
+             "have more than one pin in the block of the node. Instead, it only checks the blocks that are adjacent\n"
+             "via other hyperedges (only supported for km1, might miss zero gain moves).")
+            ((initial_partitioning ? "i-r-jet-num-iterations" : "r-jet-num-iterations"),
+             po::value<size_t>((!initial_partitioning ? &context.refinement.jet.num_iterations :
+                                &context.initial_partitioning.refinement.jet.num_iterations))->value_name(
+                     "<size_t>")->default_value(8),
+             "Jet refiner stops after this number of iterations without improving the best balanced partition.")
+            ((initial_partitioning ? "i-r-jet-relative-improvement-threshold" : "r-jet-relative-improvement-threshold"),
+             po::value<double>((!initial_partitioning ? &context.refinement.jet.relative_improvement_threshold :
+                                &context.initial_partitioning.refinement.jet.relative_improvement_threshold))->value_name(
+                     "<double>")->default_value(0.001),
+             "An iteration of the Jet refiner only counts as an improvement if it improves the best\n"
+             "balanced partition by at least this fraction.")
+            ((initial_partitioning ? "i-r-jet-negative-gain-factor" : "r-jet-negative-gain-factor"),
+             po::value<double>((!initial_partitioning ? &context.refinement.jet.negative_gain_factor :
+                                &context.initial_partitioning.refinement.jet.negative_gain_factor))->value_name(
+                     "<double>")->default_value(0.25),
+             "A node with a negative gain move is a move candidate of the Jet refiner if the loss of the move\n"
+             "is smaller than this factor times the penalty term of the node.")
+            ((initial_partitioning ? "i-r-jet-afterburner-he-size-threshold" : "r-jet-afterburner-he-size-threshold"),
+             po::value<size_t>((!initial_partitioning ? &context.refinement.jet.afterburner_he_size_threshold :
+                                &context.initial_partitioning.refinement.jet.afterburner_he_size_threshold))->value_name(
+                     "<size_t>")->default_value(1000),
+             "The afterburner of the Jet refiner only considers the moves of other candidates for hyperedges\n"
+             "with a size less than or equal to this threshold.")
             ((initial_partitioning ? "i-r-fm-type" : "r-fm-type"),
              po::value<std::string>()->value_name("<string>")->notifier(
                      [&, initial_partitioning](const std::string& type) {
@@ -401,6 +462,7 @@ namespace mt_kahypar {
              "FM Algorithm:\n"
              "- kway_fm\n"
              "- unconstrained_fm\n"
+             "- deterministic_fm\n"
              "- do_nothing")
             ((initial_partitioning ? "i-r-fm-multitry-rounds" : "r-fm-multitry-rounds"),
              po::value<size_t>((initial_partitioning ? &context.initial_partitioning.refinement.fm.multitry_rounds :
@@ -439,6 +501,11 @@ namespace mt_kahypar {
              po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.fm.release_nodes :
                               &context.refinement.fm.release_nodes))->value_name("<bool>")->default_value(true),
              "FM releases nodes that weren't moved, so they might be found by another search.")
+            ((initial_partitioning ? "i-r-fm-numa-aware-seeds" : "r-fm-numa-aware-seeds"),
+             po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.fm.numa_aware_seeds :
+                              &context.refinement.fm.numa_aware_seeds))->value_name("<bool>")->default_value(false),
+             "Assigns the seed nodes of the localized FM searches to threads on the NUMA node that owns their vertex ID range\n"
+             "and steals seeds from threads on the same NUMA node first (requires thread pinning and multiple NUMA nodes).")
             ((initial_partitioning ? "i-r-fm-threshold-border-node-inclusion" : "r-fm-threshold-border-node-inclusion"),
              po::value<double>((initial_partitioning ? &context.initial_partitioning.refinement.fm.treshold_border_node_inclusion :
                               &context.refinement.fm.treshold_border_node_inclusion))->value_name("<double>")->default_value(0.75),
@@ -480,6 +547,27 @@ namespace mt_kahypar {
                      (initial_partitioning ? &context.initial_partitioning.refinement.fm.obey_minimal_parallelism :
                       &context.refinement.fm.obey_minimal_parallelism))->value_name("<bool>")->default_value(true),
              "If true, then parallel FM refinement stops if more than a certain number of threads are finished.")
+            ((initial_partitioning ? "i-r-fm-round-tail-cutoff" : "r-fm-round-tail-cutoff"),
+             po::value<double>((initial_partitioning ? &context.initial_partitioning.refinement.fm.round_tail_cutoff :
+                                &context.refinement.fm.round_tail_cutoff))->value_name("<double>")->default_value(1.0),
+             "A multitry FM round is terminated once this fraction of the localized searches ran out of seed nodes.\n"
+             "The remaining searches then apply their best prefix such that the next round does not wait for the slowest search.\n"
+             "A value of 1.0 disables the cutoff.")
+            ((initial_partitioning ? "i-r-fm-adaptive-effort" : "r-fm-adaptive-effort"),
+             po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.fm.adaptive_effort :
+                              &context.refinement.fm.adaptive_effort))->value_name("<bool>")->default_value(false),
+             "If true, the number of FM rounds, the number of seed nodes and the length of the localized searches\n"
+             "are adapted to the relative improvement per second achieved by previous FM rounds.")
+            ((initial_partitioning ? "i-r-fm-adaptive-effort-min-rate-fraction" : "r-fm-adaptive-effort-min-rate-fraction"),
+             po::value<double>((initial_partitioning ? &context.initial_partitioning.refinement.fm.adaptive_effort_min_rate_fraction :
+                                &context.refinement.fm.adaptive_effort_min_rate_fraction))->value_name("<double>")->default_value(0.1),
+             "Adaptive FM effort: FM stops on the current level if the improvement per second of a round\n"
+             "drops below this fraction of the improvement per second of all previous rounds.")
+            ((initial_partitioning ? "i-r-fm-adaptive-effort-min-effort" : "r-fm-adaptive-effort-min-effort"),
+             po::value<double>((initial_partitioning ? &context.initial_partitioning.refinement.fm.adaptive_effort_min_effort :
+                                &context.refinement.fm.adaptive_effort_min_effort))->value_name("<double>")->default_value(0.25),
+             "Adaptive FM effort: lower bound for the factor that scales the number of rounds and seed nodes of a level\n"
+             "(must be in [0, 1]).")
             ((initial_partitioning ? "i-r-fm-time-limit-factor" : "r-fm-time-limit-factor"),
              po::value<double>((initial_partitioning ? &context.initial_partitioning.refinement.fm.time_limit_factor :
                                 &context.refinement.fm.time_limit_factor))->value_name("<double>")->default_value(0.25),
@@ -518,7 +606,21 @@ namespace mt_kahypar {
              "Rebalancer Algorithm:\n"
              "- simple_rebalancer\n"
              "- advanced_rebalancer\n"
-             "- do_nothing");
+             "- do_nothing")
+            ((initial_partitioning ? "i-r-rebalancer-use-transport-plan" : "r-rebalancer-use-transport-plan"),
+             po::value<bool>((!initial_partitioning ? &context.refinement.rebalancer_use_transport_plan :
+                              &context.initial_partitioning.refinement.rebalancer_use_transport_plan))->value_name(
+                     "<bool>")->default_value(false),
+             "If true, the advanced rebalancer first computes how much weight each overloaded block sends to which\n"
+             "block (preferring adjacent blocks, then blocks with the most slack) and only moves nodes along this plan.\n"
+             "Useful for individual part weights with very different targets.")
+            ((initial_partitioning ? "i-r-rebalancer-num-heavy-nodes" : "r-rebalancer-num-heavy-nodes"),
+             po::value<size_t>((!initial_partitioning ? &context.refinement.rebalancer_num_heavy_nodes :
+                                &context.initial_partitioning.refinement.rebalancer_num_heavy_nodes))->value_name(
+                     "<size_t>")->default_value(0),
+             "Number of heaviest nodes in overloaded blocks that the advanced rebalancer assigns first\n"
+             "(heaviest first, to the block with the tightest fitting slack) before moving light nodes by gain.\n"
+             "0 disables this stage.")
     return options;
   }
 
@@ -564,6 +666,45 @@ namespace mt_kahypar {
              po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.flows.skip_unpromising_blocks :
                       &context.refinement.flows.skip_unpromising_blocks))->value_name("<bool>"),
              "If true, than blocks for which we never found an improvement are skipped")
+            ((initial_partitioning ? "i-r-flow-skip-unchanged-regions" : "r-flow-skip-unchanged-regions"),
+             po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.flows.skip_unchanged_regions :
+                      &context.refinement.flows.skip_unchanged_regions))->value_name("<bool>"),
+             "If true, a flow problem is skipped if the region grown around a block pair is identical\n"
+             "to the region of the last search on that block pair that did not find an improvement")
+            ((initial_partitioning ? "i-r-flow-prioritize-block-pairs" : "r-flow-prioritize-block-pairs"),
+             po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.flows.prioritize_block_pairs :
+                      &context.refinement.flows.prioritize_block_pairs))->value_name("<bool>"),
+             "If true, block pairs of a round are scheduled in order of their expected improvement per second.\n"
+             "Searches on block pairs that never led to an improvement are terminated once they exceed\n"
+             "the average running time of a search.")
+            ((initial_partitioning ? "i-r-flow-disjoint-regions" : "r-flow-disjoint-regions"),
+             po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.flows.disjoint_regions :
+                      &context.refinement.flows.disjoint_regions))->value_name("<bool>"),
+             "If true, each node can only be part of the region of one search at a time. Searches on block pairs\n"
+             "that share a block then operate on disjoint vertex sets and their moves are applied concurrently.")
+            ((initial_partitioning ? "i-r-flow-max-blocks-per-region" : "r-flow-max-blocks-per-region"),
+             po::value<size_t>((initial_partitioning ? &context.initial_partitioning.refinement.flows.max_blocks_per_region :
+                      &context.refinement.flows.max_blocks_per_region))->value_name("<size_t>"),
+             "Maximum number of blocks of a region grown around a block pair. If larger than two, the region also\n"
+             "contains nodes of adjacent blocks and we solve a sequence of flow problems on all block pairs\n"
+             "of the region, which shares the region growing between the flow problems.")
+            ((initial_partitioning ? "i-r-flow-max-time-slices" : "r-flow-max-time-slices"),
+             po::value<size_t>((initial_partitioning ? &context.initial_partitioning.refinement.flows.max_time_slices :
+                      &context.refinement.flows.max_time_slices))->value_name("<size_t>"),
+             "Maximum number of time slices of a flow search. A search that reaches the time limit (r-flow-time-limit-factor)\n"
+             "yields back to the scheduler, which restarts it on the half of its region closest to the cut\n"
+             "until the search succeeds or uses all of its time slices.")
+            ((initial_partitioning ? "i-r-flow-predictor-threshold" : "r-flow-predictor-threshold"),
+             po::value<double>((initial_partitioning ? &context.initial_partitioning.refinement.flows.predictor_threshold :
+                      &context.refinement.flows.predictor_threshold))->value_name("<double>"),
+             "A block pair is not searched if the predicted probability that a search finds an improvement is below\n"
+             "this threshold. The prediction is based on the success rate of previous searches on the block pair\n"
+             "and the relative change of its cut since the last search (0.0 disables the predictor).")
+            ((initial_partitioning ? "i-r-flow-log-search-features" : "r-flow-log-search-features"),
+             po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.flows.log_search_features :
+                      &context.refinement.flows.log_search_features))->value_name("<bool>"),
+             "If true, prints a FLOW_SEARCH line with the features and the outcome of each flow search\n"
+             "(used to tune r-flow-predictor-threshold offline)")
             ((initial_partitioning ? "i-r-flow-pierce-in-bulk" : "r-flow-pierce-in-bulk"),
              po::value<bool>((initial_partitioning ? &context.initial_partitioning.refinement.flows.pierce_in_bulk :
                               &context.refinement.flows.pierce_in_bulk))->value_name("<bool>"),
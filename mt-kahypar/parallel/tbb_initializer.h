@@ -80,6 +80,17 @@ class TBBInitializer {
     return _numa_node_to_cpu_id.size();
   }
 
+  // ! NUMA node of the CPU to which the thread in the corresponding
+  // ! slot of the global task arena is pinned. If there are more threads
+  // ! than CPUs, the remaining slots are not pinned and we assign them to
+  // ! the first NUMA node.
+  int numa_node_of_thread(const int thread_id) const {
+    if ( thread_id < 0 || static_cast<size_t>(thread_id) >= _thread_to_numa_node.size() ) {
+      return 0;
+    }
+    return _thread_to_numa_node[thread_id];
+  }
+
   hwloc_cpuset_t used_cpuset() const {
     hwloc_cpuset_t cpuset = hwloc_bitmap_alloc();
     for ( const auto& numa_node : _numa_node_to_cpu_id ) {
@@ -102,7 +113,8 @@ class TBBInitializer {
     _gc(tbb::global_control::max_allowed_parallelism, num_threads),
     _global_observer(nullptr),
     _cpus(),
-    _numa_node_to_cpu_id() {
+    _numa_node_to_cpu_id(),
+    _thread_to_numa_node() {
     HwTopology& topology = HwTopology::instance();
     int num_numa_nodes = topology.num_numa_nodes();
     DBG << "Initialize TBB with" << num_threads << "threads";
@@ -133,6 +145,7 @@ class TBBInitializer {
       int node = topology.numa_node_of_cpu(cpu_id);
       ASSERT(node < static_cast<int>(_numa_node_to_cpu_id.size()));
       _numa_node_to_cpu_id[node].push_back(cpu_id);
+      _thread_to_numa_node.push_back(node);
     }
     while( !_numa_node_to_cpu_id.empty() && _numa_node_to_cpu_id.back().empty() ) {
       _numa_node_to_cpu_id.pop_back();
@@ -144,6 +157,7 @@ class TBBInitializer {
   std::unique_ptr<ThreadPinningObserver> _global_observer;
   std::vector<int> _cpus;
   std::vector<std::vector<int>> _numa_node_to_cpu_id;
+  std::vector<int> _thread_to_numa_node;
 };
 }  // namespace parallel
 }  // namespace mt_kahypar
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
 
 #include "mt-kahypar/parallel/atomic_wrapper.h"
@@ -61,11 +62,30 @@ struct ThreadQueue {
   }
 };
 
+// ! Statistics of a work container for a NUMA node
+struct NumaWorkStats {
+  // ! Elements assigned to the queues of the NUMA node
+  CAtomic<size_t> assigned;
+  // ! Elements stolen by threads of the NUMA node from queues on the same NUMA node
+  CAtomic<size_t> local_steals;
+  // ! Elements stolen by threads of the NUMA node from queues on other NUMA nodes
+  CAtomic<size_t> remote_steals;
+
+  NumaWorkStats() :
+    assigned(0),
+    local_steals(0),
+    remote_steals(0) { }
+};
+
 template<typename T>
 struct WorkContainer {
 
   WorkContainer(size_t maxNumThreads = 0) :
-    tls_queues(maxNumThreads) { }
+    tls_queues(maxNumThreads),
+    numa_node_of_queue(),
+    queues_of_numa_node(),
+    non_empty_numa_nodes(),
+    numa_stats() { }
 
   size_t unsafe_size() const {
     size_t sz = 0;
@@ -84,7 +104,8 @@ struct WorkContainer {
 
   bool try_pop(T& dest, size_t thread_id) {
     ASSERT(thread_id < tls_queues.size());
-    return tls_queues[thread_id].try_pop(dest) || steal_work(dest);
+    return tls_queues[thread_id].try_pop(dest) ||
+      ( isNumaAware() ? steal_work_numa_aware(dest, thread_id) : steal_work(dest) );
   }
 
   bool steal_work(T& dest) {
@@ -96,6 +117,88 @@ struct WorkContainer {
     return false;
   }
 
+  // ! Steals work first from the queues on the NUMA node of the thread
+  // ! and only afterwards from queues on other NUMA nodes
+  bool steal_work_numa_aware(T& dest, size_t thread_id) {
+    const int numa_node = numa_node_of_queue[thread_id];
+    for (const size_t q : queues_of_numa_node[numa_node]) {
+      if (tls_queues[q].try_pop(dest)) {
+        numa_stats[numa_node].local_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    for (size_t node = 0; node < queues_of_numa_node.size(); ++node) {
+      if (static_cast<int>(node) != numa_node) {
+        for (const size_t q : queues_of_numa_node[node]) {
+          if (tls_queues[q].try_pop(dest)) {
+            numa_stats[numa_node].remote_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  // ! Assigns each thread queue to a NUMA node (numa_node[i] is the NUMA node of
+  // ! the thread that owns queue i). Afterwards, work is stolen first on the same NUMA node.
+  void setNumaNodes(const vec<int>& numa_node) {
+    ASSERT(numa_node.size() == tls_queues.size());
+    numa_node_of_queue = numa_node;
+    queues_of_numa_node.clear();
+    for (size_t q = 0; q < numa_node_of_queue.size(); ++q) {
+      const size_t node = numa_node_of_queue[q];
+      if (node >= queues_of_numa_node.size()) {
+        queues_of_numa_node.resize(node + 1);
+      }
+      queues_of_numa_node[node].push_back(q);
+    }
+    non_empty_numa_nodes.clear();
+    for (size_t node = 0; node < queues_of_numa_node.size(); ++node) {
+      if (!queues_of_numa_node[node].empty()) {
+        non_empty_numa_nodes.push_back(node);
+      }
+    }
+    numa_stats = vec<NumaWorkStats>(queues_of_numa_node.size());
+  }
+
+  bool isNumaAware() const {
+    return non_empty_numa_nodes.size() > 1;
+  }
+
+  // ! Number of NUMA nodes that own at least one queue
+  size_t numNonEmptyNumaNodes() const {
+    return non_empty_numa_nodes.size();
+  }
+
+  // ! Moves each element into a queue of the i-th NUMA node that owns at least one queue,
+  // ! where i = numa_index_of(el) < numNonEmptyNumaNodes(). The elements of a NUMA node
+  // ! are distributed round-robin among its queues.
+  // ! Assumes that no thread is currently calling try_pop.
+  template<typename F>
+  void distribute_to_numa_nodes(const F& numa_index_of) {
+    ASSERT(isNumaAware());
+    vec<T> elements;
+    elements.reserve(unsafe_size());
+    for (ThreadQueue<T>& q : tls_queues) {
+      elements.insert(elements.end(), q.elements.cbegin(), q.elements.cend());
+      q.clear();
+    }
+    vec<size_t> next_queue(non_empty_numa_nodes.size(), 0);
+    vec<size_t> num_assigned(non_empty_numa_nodes.size(), 0);
+    for (const T& el : elements) {
+      const size_t i = numa_index_of(el);
+      ASSERT(i < non_empty_numa_nodes.size());
+      const vec<size_t>& queues = queues_of_numa_node[non_empty_numa_nodes[i]];
+      tls_queues[queues[next_queue[i]]].elements.push_back(el);
+      next_queue[i] = next_queue[i] + 1 < queues.size() ? next_queue[i] + 1 : 0;
+      ++num_assigned[i];
+    }
+    for (size_t i = 0; i < non_empty_numa_nodes.size(); ++i) {
+      numa_stats[non_empty_numa_nodes[i]].assigned.fetch_add(num_assigned[i], std::memory_order_relaxed);
+    }
+  }
+
   void shuffle() {
     tbb::parallel_for_each(tls_queues, [&](ThreadQueue<T>& q) {
       utils::Randomize::instance().shuffleVector(q.elements);
@@ -110,6 +213,12 @@ struct WorkContainer {
 
   vec<ThreadQueue<T>> tls_queues;
 
+  // ! NUMA node of each thread queue (only set if the work container is NUMA-aware)
+  vec<int> numa_node_of_queue;
+  vec<vec<size_t>> queues_of_numa_node;
+  vec<size_t> non_empty_numa_nodes;
+  vec<NumaWorkStats> numa_stats;
+
   using SubRange = IteratorRange< typename vec<T>::const_iterator >;
   using Range = ConcatenatedRange<SubRange>;
 
@@ -128,10 +128,21 @@ namespace mt_kahypar {
       str << "    Rebalancing:                      " << std::boolalpha << params.rebalancing << std::endl;
       str << "    HE Size Activation Threshold:     " << std::boolalpha << params.hyperedge_size_activation_threshold << std::endl;
       str << "    Relative Improvement Threshold:   " << params.relative_improvement_threshold << std::endl;
+      str << "    Use Gain Buckets:                 " << std::boolalpha << params.use_gain_buckets << std::endl;
+      str << "    HE Size Gain Threshold:           " << params.hyperedge_size_gain_threshold << std::endl;
     }
     return str;
   }
 
+  std::ostream & operator<< (std::ostream& str, const JetParameters& params) {
+    str << "  Jet Parameters:" << std::endl;
+    str << "    Iterations Without Improvement:   " << params.num_iterations << std::endl;
+    str << "    Relative Improvement Threshold:   " << params.relative_improvement_threshold << std::endl;
+    str << "    Negative Gain Factor:             " << params.negative_gain_factor << std::endl;
+    str << "    Afterburner HE Size Threshold:    " << params.afterburner_he_size_threshold << std::endl;
+    return str;
+  }
+
   std::ostream& operator<<(std::ostream& out, const FMParameters& params) {
     out << "  FM Parameters: \n";
     out << "    Algorithm:                        " << params.algorithm << std::endl;
@@ -142,9 +153,16 @@ namespace mt_kahypar {
       out << "    Num Seed Nodes:                   " << params.num_seed_nodes << std::endl;
       out << "    Enable Random Shuffle:            " << std::boolalpha << params.shuffle << std::endl;
       out << "    Obey Minimal Parallelism:         " << std::boolalpha << params.obey_minimal_parallelism << std::endl;
+      out << "    Round Tail Cutoff:                " << params.round_tail_cutoff << std::endl;
       out << "    Minimum Improvement Factor:       " << params.min_improvement << std::endl;
       out << "    Release Nodes:                    " << std::boolalpha << params.release_nodes << std::endl;
+      out << "    NUMA-Aware Seeds:                 " << std::boolalpha << params.numa_aware_seeds << std::endl;
       out << "    Time Limit Factor:                " << params.time_limit_factor << std::endl;
+      out << "    Adaptive Effort:                  " << std::boolalpha << params.adaptive_effort << std::endl;
+      if ( params.adaptive_effort ) {
+        out << "    Adaptive Effort Min Rate Fraction:" << params.adaptive_effort_min_rate_fraction << std::endl;
+        out << "    Adaptive Effort Min Effort:       " << params.adaptive_effort_min_effort << std::endl;
+      }
     }
     if ( params.algorithm == FMAlgorithm::unconstrained_fm ) {
       out << "    Unconstrained Rounds:             " << params.unconstrained_rounds << std::endl;
@@ -188,6 +206,13 @@ namespace mt_kahypar {
       out << "    Time Limit Factor:                " << params.time_limit_factor << std::endl;
       out << "    Skip Small Cuts:                  " << std::boolalpha << params.skip_small_cuts << std::endl;
       out << "    Skip Unpromising Blocks:          " << std::boolalpha << params.skip_unpromising_blocks << std::endl;
+      out << "    Skip Unchanged Regions:           " << std::boolalpha << params.skip_unchanged_regions << std::endl;
+      out << "    Prioritize Block Pairs:           " << std::boolalpha << params.prioritize_block_pairs << std::endl;
+      out << "    Disjoint Regions:                 " << std::boolalpha << params.disjoint_regions << std::endl;
+      out << "    Maximum Blocks Per Region:        " << params.max_blocks_per_region << std::endl;
+      out << "    Maximum Time Slices:              " << params.max_time_slices << std::endl;
+      out << "    Predictor Threshold:              " << params.predictor_threshold << std::endl;
+      out << "    Log Search Features:              " << std::boolalpha << params.log_search_features << std::endl;
       out << "    Pierce in Bulk:                   " << std::boolalpha << params.pierce_in_bulk << std::endl;
       out << "    Steiner Tree Policy:              " << params.steiner_tree_policy << std::endl;
       out << std::flush;
@@ -197,6 +222,7 @@ namespace mt_kahypar {
 
   std::ostream& operator<<(std::ostream& out, const DeterministicRefinementParameters& params) {
     out << "    Number of sub-rounds for Sync LP:  " << params.num_sub_rounds_sync_lp << std::endl;
+    out << "    Number of sub-rounds for Det. FM:  " << params.num_sub_rounds_fm << std::endl;
     out << "    Use active node set:               " << std::boolalpha << params.use_active_node_set << std::endl;
     return out;
   }
@@ -204,11 +230,19 @@ namespace mt_kahypar {
   std::ostream & operator<< (std::ostream& str, const RefinementParameters& params) {
     str << "Refinement Parameters:" << std::endl;
     str << "  Rebalancing Algorithm:              " << params.rebalancer << std::endl;
+    str << "  Rebalancer Uses Transport Plan:     " << std::boolalpha << params.rebalancer_use_transport_plan << std::endl;
+    str << "  Rebalancer Num Heavy Nodes:         " << params.rebalancer_num_heavy_nodes << std::endl;
     str << "  Refine Until No Improvement:        " << std::boolalpha << params.refine_until_no_improvement << std::endl;
     str << "  Relative Improvement Threshold:     " << params.relative_improvement_threshold << std::endl;
     str << "  Maximum Batch Size:                 " << params.max_batch_size << std::endl;
     str << "  Min Border Vertices Per Thread:     " << params.min_border_vertices_per_thread << std::endl;
+    str << "  Gain Cache Large HE Threshold:      " << params.gain_cache_large_he_threshold << std::endl;
+    str << "  Lazy Gain Cache Initialization:     " << std::boolalpha << params.lazy_gain_cache_initialization << std::endl;
+    str << "  Gain Cache Tracks Adjacent Blocks:  " << std::boolalpha << params.gain_cache_track_adjacent_blocks << std::endl;
     str << "\n" << params.label_propagation;
+    if ( params.label_propagation.algorithm == LabelPropagationAlgorithm::jet ) {
+      str << "\n" << params.jet;
+    }
     str << "\n" << params.fm;
     if ( params.global_fm.use_global_fm ) {
       str << "\n" << params.global_fm;
@@ -392,12 +426,34 @@ namespace mt_kahypar {
 
     shared_memory.static_balancing_work_packages = std::clamp(shared_memory.static_balancing_work_packages, UL(4), UL(256));
 
+    for ( const RefinementParameters* params : { &refinement, &initial_partitioning.refinement } ) {
+      if ( params->gain_cache_track_adjacent_blocks &&
+           params->gain_cache_large_he_threshold != std::numeric_limits<HypernodeID>::max() ) {
+        // Blocks that are only adjacent via a large net have a zero cached benefit term
+        throw InvalidParameterException(
+          "Tracking adjacent blocks in the gain cache cannot be combined with "
+          "excluding large nets from the gain cache.");
+      }
+      if ( params->fm.adaptive_effort_min_effort < 0.0 || params->fm.adaptive_effort_min_effort > 1.0 ) {
+        throw InvalidParameterException(
+          "The minimum effort of the adaptive FM effort controller must be in [0, 1].");
+      }
+      if ( params->fm.round_tail_cutoff <= 0.0 || params->fm.round_tail_cutoff > 1.0 ) {
+        throw InvalidParameterException(
+          "The round tail cutoff of FM must be in (0, 1].");
+      }
+    }
+
     if ( partition.deterministic ) {
       coarsening.algorithm = CoarseningAlgorithm::deterministic_multilevel_coarsener;
 
-      // disable FM until we have a deterministic version
-      refinement.fm.algorithm = FMAlgorithm::do_nothing;
-      initial_partitioning.refinement.fm.algorithm = FMAlgorithm::do_nothing;
+      // disable FM unless its deterministic version is requested
+      if ( refinement.fm.algorithm != FMAlgorithm::deterministic_fm ) {
+        refinement.fm.algorithm = FMAlgorithm::do_nothing;
+      }
+      if ( initial_partitioning.refinement.fm.algorithm != FMAlgorithm::deterministic_fm ) {
+        initial_partitioning.refinement.fm.algorithm = FMAlgorithm::do_nothing;
+      }
 
       // disable adaptive IP
       initial_partitioning.use_adaptive_ip_runs = false;
@@ -698,9 +754,15 @@ namespace mt_kahypar {
     // refinement -> deterministic
     refinement.deterministic_refinement.num_sub_rounds_sync_lp = 1;
     refinement.deterministic_refinement.use_active_node_set = true;
+    refinement.deterministic_refinement.num_sub_rounds_fm = 4;
 
     // refinement -> fm
-    refinement.fm.algorithm = FMAlgorithm::do_nothing;
+    refinement.fm.algorithm = FMAlgorithm::deterministic_fm;
+    refinement.fm.multitry_rounds = 10;
+    refinement.fm.rollback_parallel = true;
+    refinement.fm.rollback_balance_violation_factor = 1.0;
+    refinement.fm.num_seed_nodes = 25;
+    refinement.fm.min_improvement = -1;
 
     // refinement -> flows
     refinement.flows.algorithm = FlowAlgorithm::do_nothing;
@@ -138,10 +138,21 @@ struct LabelPropagationParameters {
   bool execute_sequential = false;
   size_t hyperedge_size_activation_threshold = std::numeric_limits<size_t>::max();
   double relative_improvement_threshold = -1.0;
+  bool use_gain_buckets = false;
+  size_t hyperedge_size_gain_threshold = std::numeric_limits<size_t>::max();
 };
 
 std::ostream & operator<< (std::ostream& str, const LabelPropagationParameters& params);
 
+struct JetParameters {
+  size_t num_iterations = 8;
+  double relative_improvement_threshold = 0.001;
+  double negative_gain_factor = 0.25;
+  size_t afterburner_he_size_threshold = 1000;
+};
+
+std::ostream & operator<< (std::ostream& str, const JetParameters& params);
+
 struct FMParameters {
   FMAlgorithm algorithm = FMAlgorithm::do_nothing;
 
@@ -151,12 +162,19 @@ struct FMParameters {
   double rollback_balance_violation_factor = std::numeric_limits<double>::max();
   double min_improvement = -1.0;
   double time_limit_factor = std::numeric_limits<double>::max();
+  double round_tail_cutoff = 1.0;
 
   bool rollback_parallel = true;
   bool iter_moves_on_recalc = false;
   bool shuffle = true;
   mutable bool obey_minimal_parallelism = false;
   bool release_nodes = true;
+  bool numa_aware_seeds = false;
+
+  // adaptive effort
+  bool adaptive_effort = false;
+  double adaptive_effort_min_rate_fraction = 0.1;
+  double adaptive_effort_min_effort = 0.25;
 
   // unconstrained
   size_t unconstrained_rounds = 1;
@@ -195,6 +213,13 @@ struct FlowParameters {
   double time_limit_factor = 0.0;
   bool skip_small_cuts = false;
   bool skip_unpromising_blocks = false;
+  bool skip_unchanged_regions = false;
+  bool prioritize_block_pairs = false;
+  bool disjoint_regions = false;
+  size_t max_blocks_per_region = 2;
+  size_t max_time_slices = 1;
+  double predictor_threshold = 0.0;
+  bool log_search_features = false;
   bool pierce_in_bulk = false;
   SteinerTreeFlowValuePolicy steiner_tree_policy = SteinerTreeFlowValuePolicy::UNDEFINED;
 };
@@ -203,6 +228,7 @@ std::ostream& operator<<(std::ostream& out, const FlowParameters& params);
 
 struct DeterministicRefinementParameters {
   size_t num_sub_rounds_sync_lp = 5;
+  size_t num_sub_rounds_fm = 4;
   bool use_active_node_set = false;
 };
 
@@ -210,15 +236,21 @@ std::ostream& operator<<(std::ostream& out, const DeterministicRefinementParamet
 
 struct RefinementParameters {
   LabelPropagationParameters label_propagation;
+  JetParameters jet;
   FMParameters fm;
   DeterministicRefinementParameters deterministic_refinement;
   NLevelGlobalFMParameters global_fm;
   FlowParameters flows;
   RebalancingAlgorithm rebalancer = RebalancingAlgorithm::do_nothing;
+  bool rebalancer_use_transport_plan = false;
+  size_t rebalancer_num_heavy_nodes = 0;
   bool refine_until_no_improvement = false;
   double relative_improvement_threshold = 0.0;
   size_t max_batch_size = std::numeric_limits<size_t>::max();
   size_t min_border_vertices_per_thread = 0;
+  HypernodeID gain_cache_large_he_threshold = std::numeric_limits<HypernodeID>::max();
+  bool lazy_gain_cache_initialization = false;
+  bool gain_cache_track_adjacent_blocks = false;
 };
 
 std::ostream & operator<< (std::ostream& str, const RefinementParameters& params);
@@ -220,6 +220,7 @@ namespace mt_kahypar {
     switch (algo) {
       case LabelPropagationAlgorithm::label_propagation: return os << "label_propagation";
       case LabelPropagationAlgorithm::deterministic: return os << "deterministic";
+      case LabelPropagationAlgorithm::jet: return os << "jet";
       case LabelPropagationAlgorithm::do_nothing: return os << "lp_do_nothing";
         // omit default case to trigger compiler warning for missing cases
     }
@@ -230,6 +231,7 @@ namespace mt_kahypar {
     switch (algo) {
       case FMAlgorithm::kway_fm: return os << "kway_fm";
       case FMAlgorithm::unconstrained_fm: return os << "unconstrained_fm";
+      case FMAlgorithm::deterministic_fm: return os << "deterministic_fm";
       case FMAlgorithm::do_nothing: return os << "fm_do_nothing";
         // omit default case to trigger compiler warning for missing cases
     }
@@ -437,6 +439,8 @@ namespace mt_kahypar {
       return LabelPropagationAlgorithm::label_propagation;
     } else if (type == "deterministic") {
       return LabelPropagationAlgorithm::deterministic;
+    } else if (type == "jet") {
+      return LabelPropagationAlgorithm::jet;
     } else if (type == "do_nothing") {
       return LabelPropagationAlgorithm::do_nothing;
     }
@@ -449,6 +453,8 @@ namespace mt_kahypar {
       return FMAlgorithm::kway_fm;
     } else if (type == "unconstrained_fm") {
       return FMAlgorithm::unconstrained_fm;
+    } else if (type == "deterministic_fm") {
+      return FMAlgorithm::deterministic_fm;
     } else if (type == "do_nothing") {
       return FMAlgorithm::do_nothing;
     }
@@ -150,12 +150,14 @@ enum class InitialPartitioningAlgorithm : uint8_t {
 enum class LabelPropagationAlgorithm : uint8_t {
   label_propagation,
   deterministic,
+  jet,
   do_nothing
 };
 
 enum class FMAlgorithm : uint8_t {
   kway_fm,
   unconstrained_fm,
+  deterministic_fm,
   do_nothing
 };
 
@@ -0,0 +1,336 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+#include "mt-kahypar/partition/refinement/deterministic/deterministic_fm.h"
+
+#include <algorithm>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include "mt-kahypar/definitions.h"
+#include "mt-kahypar/datastructures/streaming_vector.h"
+#include "mt-kahypar/parallel/chunking.h"
+#include "mt-kahypar/partition/metrics.h"
+#include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
+#include "mt-kahypar/utils/utilities.h"
+#include "mt-kahypar/utils/timer.h"
+#include "mt-kahypar/utils/cast.h"
+
+namespace mt_kahypar {
+
+  template<typename GraphAndGainTypes>
+  bool DeterministicFMRefiner<GraphAndGainTypes>::refineImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph,
+                                                             const vec<HypernodeID>& refinement_nodes,
+                                                             Metrics& best_metrics,
+                                                             const double) {
+    PartitionedHypergraph& phg = utils::cast<PartitionedHypergraph>(hypergraph);
+    resizeDataStructuresForCurrentK();
+    utils::Timer& timer = utils::Utilities::instance().getTimer(_context.utility_id);
+
+    Gain overall_improvement = 0;
+    size_t consecutive_rounds_with_too_little_improvement = 0;
+    vec<HypernodeWeight> initial_part_weights(static_cast<size_t>(_context.partition.k));
+    const size_t num_sub_rounds_param = std::max(
+      _context.refinement.deterministic_refinement.num_sub_rounds_fm, UL(1));
+    const size_t num_seeds = std::max(_context.refinement.fm.num_seed_nodes, UL(1));
+
+    for ( size_t round = 0; round < _context.refinement.fm.multitry_rounds; ++round ) {
+      for ( PartitionID i = 0; i < _context.partition.k; ++i ) {
+        initial_part_weights[i] = phg.partWeight(i);
+      }
+
+      timer.start_timer("collect_border_nodes", "Collect Border Nodes");
+      collectSeedNodes(phg, refinement_nodes);
+      timer.stop_timer("collect_border_nodes");
+      if ( _border_nodes.empty() ) {
+        break;
+      }
+
+      const size_t num_border_nodes = _border_nodes.size();
+      const size_t num_sub_rounds = std::min(num_sub_rounds_param, num_border_nodes);
+      const size_t sub_round_size = parallel::chunking::idiv_ceil(num_border_nodes, num_sub_rounds);
+      for ( size_t sub_round = 0; sub_round < num_sub_rounds; ++sub_round ) {
+        const size_t first = std::min(sub_round * sub_round_size, num_border_nodes);
+        const size_t last = std::min(first + sub_round_size, num_border_nodes);
+        const size_t num_searches = parallel::chunking::idiv_ceil(last - first, num_seeds);
+        if ( num_searches == 0 ) {
+          continue;
+        }
+
+        timer.start_timer("find_moves", "Find Moves");
+        if ( _search_moves.size() < num_searches ) {
+          _search_moves.resize(num_searches);
+        }
+        tbb::parallel_for(UL(0), num_searches, [&](const size_t search) {
+          const size_t begin = first + search * num_seeds;
+          const size_t end = std::min(begin + num_seeds, last);
+          _ets_search.local().findMoves(phg, _border_nodes, begin, end, _search_moves[search]);
+        });
+        timer.stop_timer("find_moves");
+
+        timer.start_timer("apply_moves", "Apply Moves");
+        applySearchResults(phg, num_searches);
+        timer.stop_timer("apply_moves");
+      }
+
+      timer.start_timer("rollback", "Rollback to Best Solution");
+      const HyperedgeWeight improvement = _global_rollback.revertToBestPrefix(
+        phg, _shared_data, initial_part_weights, _context.partition.max_part_weights);
+      timer.stop_timer("rollback");
+
+      const HyperedgeWeight old_quality = best_metrics.quality - overall_improvement;
+      const double round_improvement_fraction = old_quality == 0 ? 0.0 :
+        static_cast<double>(improvement) / static_cast<double>(old_quality);
+      overall_improvement += improvement;
+      if ( round_improvement_fraction < _context.refinement.fm.min_improvement ) {
+        consecutive_rounds_with_too_little_improvement++;
+      } else {
+        consecutive_rounds_with_too_little_improvement = 0;
+      }
+      DBG << V(round) << V(improvement) << V(metrics::quality(phg, _context))
+          << V(metrics::imbalance(phg, _context)) << V(num_border_nodes) << V(round_improvement_fraction);
+
+      // Same stopping criteria as the multitry FM refiner, but without time limit
+      if ( improvement <= 0 || consecutive_rounds_with_too_little_improvement >= 2 ) {
+        break;
+      }
+    }
+
+    best_metrics.quality -= overall_improvement;
+    best_metrics.imbalance = metrics::imbalance(phg, _context);
+    HEAVY_REFINEMENT_ASSERT(phg.checkTrackedPartitionInformation(_gain_cache));
+    ASSERT(best_metrics.quality == metrics::quality(phg, _context),
+           V(best_metrics.quality) << V(metrics::quality(phg, _context)));
+    return overall_improvement > 0;
+  }
+
+  template<typename GraphAndGainTypes>
+  void DeterministicFMRefiner<GraphAndGainTypes>::collectSeedNodes(PartitionedHypergraph& phg,
+                                                                   const vec<HypernodeID>& refinement_nodes) {
+    ds::StreamingVector<HypernodeID> border_nodes;
+    auto add_if_border_node = [&](const HypernodeID u) {
+      if ( phg.nodeIsEnabled(u) && phg.isBorderNode(u) && !phg.isFixed(u) ) {
+        border_nodes.stream(u);
+      }
+    };
+    if ( refinement_nodes.empty() ) {
+      tbb::parallel_for(ID(0), phg.initialNumNodes(), add_if_border_node);
+    } else {
+      tbb::parallel_for(UL(0), refinement_nodes.size(), [&](const size_t i) {
+        add_if_border_node(refinement_nodes[i]);
+      });
+    }
+
+    // The order in which the threads collect the border nodes is not deterministic,
+    // so we sort them before we apply the seeded permutation.
+    vec<HypernodeID> sorted_border_nodes = border_nodes.copy_parallel();
+    tbb::parallel_sort(sorted_border_nodes.begin(), sorted_border_nodes.end());
+    _permutation.shuffle(sorted_border_nodes, _context.shared_memory.static_balancing_work_packages, _prng);
+    _border_nodes.swap(_permutation.permutation);
+  }
+
+  template<typename GraphAndGainTypes>
+  void DeterministicFMRefiner<GraphAndGainTypes>::applySearchResults(PartitionedHypergraph& phg,
+                                                                     const size_t num_searches) {
+    GlobalMoveTracker& move_tracker = _shared_data.moveTracker;
+    for ( size_t search = 0; search < num_searches; ++search ) {
+      for ( const Move& m : _search_moves[search] ) {
+        if ( move_tracker.wasNodeMovedInThisRound(m.node) || phg.partID(m.node) != m.from ||
+             phg.partWeight(m.to) + phg.nodeWeight(m.node) > _context.partition.max_part_weights[m.to] ) {
+          break;
+        }
+        phg.changeNodePart(_gain_cache, m.node, m.from, m.to,
+                           std::numeric_limits<HypernodeWeight>::max(),
+                           [&] { move_tracker.insertMove(m); },
+                           [&](const SynchronizedEdgeUpdate&) { });
+      }
+      _search_moves[search].clear();
+    }
+  }
+
+  template<typename GraphAndGainTypes>
+  void DeterministicFMRefiner<GraphAndGainTypes>::LocalSearch::findMoves(PartitionedHypergraph& phg,
+                                                                          const vec<HypernodeID>& seeds,
+                                                                          const size_t begin,
+                                                                          const size_t end,
+                                                                          vec<Move>& moves) {
+    if ( ++_search_stamp == 0 ) {
+      std::fill(_moved_in_search.begin(), _moved_in_search.end(), 0);
+      _search_stamp = 1;
+    }
+    _moves.clear();
+    _pq.clear();
+    _delta_phg.clear();
+    _delta_phg.setPartitionedHypergraph(&phg);
+    _delta_gain_cache.clear();
+
+    for ( size_t i = begin; i < end; ++i ) {
+      if ( isEligible(phg, seeds[i]) ) {
+        insertIntoPQ(seeds[i]);
+      }
+    }
+
+    StopRule stop_rule(phg.initialNumNodes());
+    Gain estimated_improvement = 0;
+    Gain best_improvement = 0;
+    size_t best_prefix = 0;
+    while ( !_pq.empty() && !stop_rule.searchShouldStop() ) {
+      std::pop_heap(_pq.begin(), _pq.end());
+      const PQElement top = _pq.back();
+      _pq.pop_back();
+      const HypernodeID u = top.node;
+      if ( _moved_in_search[u] == _search_stamp ) {
+        continue;
+      }
+
+      // The gain of u may have decreased since it was inserted into the PQ
+      const PartitionID from = _delta_phg.partID(u);
+      const auto [to, gain] = computeBestTargetBlock(u, from);
+      if ( to == kInvalidPartition ) {
+        continue;
+      } else if ( gain < top.gain ) {
+        _pq.push_back(PQElement { gain, u });
+        std::push_heap(_pq.begin(), _pq.end());
+        continue;
+      }
+
+      _edges_with_gain_changes.clear();
+      const bool moved = _delta_phg.changeNodePart(u, from, to,
+        _context.partition.max_part_weights[to], [&](const SynchronizedEdgeUpdate& sync_update) {
+          if ( !PartitionedHypergraph::is_graph && GainCache::triggersDeltaGainUpdate(sync_update) ) {
+            _edges_with_gain_changes.push_back(sync_update.he);
+          }
+          _delta_gain_cache.deltaGainUpdate(_delta_phg, sync_update);
+        });
+      if ( moved ) {
+        _moved_in_search[u] = _search_stamp;
+        _moves.push_back(Move { from, to, u, gain });
+        estimated_improvement += gain;
+        stop_rule.update(gain);
+        if ( estimated_improvement > best_improvement ) {
+          best_improvement = estimated_improvement;
+          best_prefix = _moves.size();
+          stop_rule.reset();
+        }
+        insertNeighbors(phg, u);
+      }
+    }
+
+    moves.assign(_moves.begin(), _moves.begin() + best_prefix);
+  }
+
+  template<typename GraphAndGainTypes>
+  std::pair<PartitionID, Gain> DeterministicFMRefiner<GraphAndGainTypes>::LocalSearch::computeBestTargetBlock(
+    const HypernodeID u, const PartitionID from) const {
+    const HypernodeWeight wu = _delta_phg.nodeWeight(u);
+    PartitionID to = kInvalidPartition;
+    HyperedgeWeight to_benefit = std::numeric_limits<HyperedgeWeight>::min();
+    HypernodeWeight best_to_weight = _delta_phg.partWeight(from) - wu;
+    // The order of the adjacent blocks depends on the order of previous gain cache
+    // updates. Thus, we break ties by the block ID to obtain a deterministic target.
+    for ( const PartitionID& i : _delta_gain_cache.adjacentBlocks(u) ) {
+      if ( i != from ) {
+        const HypernodeWeight to_weight = _delta_phg.partWeight(i);
+        const HyperedgeWeight benefit = _delta_gain_cache.benefitTerm(u, i);
+        const bool is_better = benefit > to_benefit || ( benefit == to_benefit &&
+          ( to_weight < best_to_weight || ( to_weight == best_to_weight && i < to ) ) );
+        if ( is_better && to_weight + wu <= _context.partition.max_part_weights[i] ) {
+          to_benefit = benefit;
+          to = i;
+          best_to_weight = to_weight;
+        }
+      }
+    }
+    const Gain gain = to != kInvalidPartition ? to_benefit - _delta_gain_cache.penaltyTerm(u, from)
+                                              : std::numeric_limits<HyperedgeWeight>::min();
+    return std::make_pair(to, gain);
+  }
+
+  template<typename GraphAndGainTypes>
+  void DeterministicFMRefiner<GraphAndGainTypes>::LocalSearch::insertIntoPQ(const HypernodeID u) {
+    const auto [to, gain] = computeBestTargetBlock(u, _delta_phg.partID(u));
+    if ( to != kInvalidPartition ) {
+      _pq.push_back(PQElement { gain, u });
+      std::push_heap(_pq.begin(), _pq.end());
+    }
+  }
+
+  template<typename GraphAndGainTypes>
+  void DeterministicFMRefiner<GraphAndGainTypes>::LocalSearch::insertNeighbors(const PartitionedHypergraph& phg,
+                                                                                const HypernodeID u) {
+    if constexpr ( PartitionedHypergraph::is_graph ) {
+      for ( const HyperedgeID& e : phg.incidentEdges(u) ) {
+        const HypernodeID v = phg.edgeTarget(e);
+        if ( isEligible(phg, v) ) {
+          insertIntoPQ(v);
+        }
+      }
+    } else {
+      if ( ++_deduplication_time == 0 ) {
+        std::fill(_neighbor_deduplicator.begin(), _neighbor_deduplicator.end(), 0);
+        _deduplication_time = 1;
+      }
+      for ( const HyperedgeID& e : _edges_with_gain_changes ) {
+        if ( phg.edgeSize(e) < _context.partition.ignore_hyperedge_size_threshold ) {
+          for ( const HypernodeID& v : phg.pins(e) ) {
+            if ( _neighbor_deduplicator[v] != _deduplication_time && isEligible(phg, v) ) {
+              _neighbor_deduplicator[v] = _deduplication_time;
+              insertIntoPQ(v);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  template<typename GraphAndGainTypes>
+  void DeterministicFMRefiner<GraphAndGainTypes>::initializeImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph) {
+    PartitionedHypergraph& phg = utils::cast<PartitionedHypergraph>(hypergraph);
+    if ( !_gain_cache.isInitialized() ) {
+      _gain_cache.initializeGainCache(phg);
+    }
+  }
+
+  template<typename GraphAndGainTypes>
+  void DeterministicFMRefiner<GraphAndGainTypes>::resizeDataStructuresForCurrentK() {
+    // If the number of blocks changes, we resize data structures
+    // (can happen during deep multilevel partitioning)
+    if ( _current_k != _context.partition.k ) {
+      _current_k = _context.partition.k;
+      _global_rollback.changeNumberOfBlocks(_current_k);
+      for ( LocalSearch& search : _ets_search ) {
+        search.changeNumberOfBlocks(_current_k);
+      }
+      _gain_cache.changeNumberOfBlocks(_current_k);
+    }
+  }
+
+  namespace {
+  #define DETERMINISTIC_FM_REFINER(X) DeterministicFMRefiner<X>
+  }
+
+  // explicitly instantiate so the compiler can generate them when compiling this cpp file
+  INSTANTIATE_CLASS_WITH_VALID_TRAITS(DETERMINISTIC_FM_REFINER)
+}
@@ -0,0 +1,196 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include "mt-kahypar/partition/context.h"
+#include "mt-kahypar/partition/refinement/i_refiner.h"
+#include "mt-kahypar/partition/refinement/i_rebalancer.h"
+#include "mt-kahypar/partition/refinement/fm/fm_commons.h"
+#include "mt-kahypar/partition/refinement/fm/global_rollback.h"
+#include "mt-kahypar/partition/refinement/fm/stop_rule.h"
+#include "mt-kahypar/partition/refinement/gains/gain_cache_ptr.h"
+#include "mt-kahypar/utils/reproducible_random.h"
+
+namespace mt_kahypar {
+
+/**
+ * Deterministic variant of the multitry k-way FM refiner.
+ * The border nodes of a round are shuffled with a seeded parallel permutation
+ * and split into sub-rounds. Within a sub-round, the localized searches run in
+ * parallel on a frozen partition (each search only sees its own moves via a delta
+ * partition) and each search owns a fixed range of the seed nodes. Afterwards, the best
+ * prefixes of the searches are applied sequentially in the order of their search IDs.
+ * The global rollback then reverts to the best prefix of the resulting move sequence.
+ * Hence, the result does not depend on thread timing or the number of threads.
+ */
+template<typename GraphAndGainTypes>
+class DeterministicFMRefiner final : public IRefiner {
+
+  using PartitionedHypergraph = typename GraphAndGainTypes::PartitionedHypergraph;
+  using GainCache = typename GraphAndGainTypes::GainCache;
+  using DeltaGainCache = typename GraphAndGainTypes::DeltaGainCache;
+  using DeltaPartitionedHypergraph = typename PartitionedHypergraph::template DeltaPartition<DeltaGainCache::requires_connectivity_set>;
+
+  static constexpr bool debug = false;
+  static constexpr size_t MAP_SIZE_LARGE = 16384;
+  static constexpr size_t MAP_SIZE_MOVE_DELTA = 8192;
+
+  // ! Localized search that operates on a frozen partition. Nodes are
+  // ! ordered by gain and ties are broken by the smaller node ID.
+  class LocalSearch {
+    struct PQElement {
+      Gain gain;
+      HypernodeID node;
+
+      bool operator<(const PQElement& o) const {
+        return gain < o.gain || ( gain == o.gain && node > o.node );
+      }
+    };
+
+   public:
+    explicit LocalSearch(const Context& context,
+                         const HypernodeID num_nodes,
+                         const FMSharedData& shared_data,
+                         GainCache& gain_cache) :
+      _context(context),
+      _shared_data(shared_data),
+      _delta_phg(context),
+      _delta_gain_cache(gain_cache),
+      _pq(),
+      _moves(),
+      _edges_with_gain_changes(),
+      _moved_in_search(num_nodes, 0),
+      _search_stamp(0),
+      _neighbor_deduplicator(PartitionedHypergraph::is_graph ? 0 : num_nodes, 0),
+      _deduplication_time(0) {
+      const bool top_level = context.type == ContextType::main;
+      _delta_gain_cache.initialize(top_level ? MAP_SIZE_LARGE : MAP_SIZE_MOVE_DELTA);
+    }
+
+    // ! Runs a localized search starting from seeds[begin, end) and
+    // ! stores the best prefix of its move sequence in 'moves'
+    void findMoves(PartitionedHypergraph& phg,
+                   const vec<HypernodeID>& seeds,
+                   const size_t begin,
+                   const size_t end,
+                   vec<Move>& moves);
+
+    void changeNumberOfBlocks(const PartitionID new_k) {
+      _delta_phg.changeNumberOfBlocks(new_k);
+    }
+
+   private:
+    std::pair<PartitionID, Gain> computeBestTargetBlock(const HypernodeID u, const PartitionID from) const;
+
+    void insertIntoPQ(const HypernodeID u);
+
+    void insertNeighbors(const PartitionedHypergraph& phg, const HypernodeID u);
+
+    bool isEligible(const PartitionedHypergraph& phg, const HypernodeID u) const {
+      return _moved_in_search[u] != _search_stamp &&
+        !( phg.hasFixedVertices() && phg.isFixed(u) ) &&
+        !_shared_data.moveTracker.wasNodeMovedInThisRound(u);
+    }
+
+    const Context& _context;
+    const FMSharedData& _shared_data;
+    DeltaPartitionedHypergraph _delta_phg;
+    DeltaGainCache _delta_gain_cache;
+    vec<PQElement> _pq;
+    vec<Move> _moves;
+    vec<HyperedgeID> _edges_with_gain_changes;
+    vec<uint32_t> _moved_in_search;
+    uint32_t _search_stamp;
+    vec<uint32_t> _neighbor_deduplicator;
+    uint32_t _deduplication_time;
+  };
+
+ public:
+  explicit DeterministicFMRefiner(const HypernodeID num_hypernodes,
+                                  const HyperedgeID num_hyperedges,
+                                  const Context& context,
+                                  GainCache& gain_cache,
+                                  IRebalancer& /* only relevant for other refiners */) :
+    _initial_num_nodes(num_hypernodes),
+    _context(context),
+    _gain_cache(gain_cache),
+    _current_k(context.partition.k),
+    _shared_data(num_hypernodes),
+    _global_rollback(num_hyperedges, context, gain_cache),
+    _ets_search([&] { return LocalSearch(_context, _initial_num_nodes, _shared_data, _gain_cache); }),
+    _prng(context.partition.seed),
+    _permutation(),
+    _border_nodes(),
+    _search_moves() { }
+
+  explicit DeterministicFMRefiner(const HypernodeID num_hypernodes,
+                                  const HyperedgeID num_hyperedges,
+                                  const Context& context,
+                                  gain_cache_t gain_cache,
+                                  IRebalancer& rb) :
+    DeterministicFMRefiner(num_hypernodes, num_hyperedges, context,
+      GainCachePtr::cast<GainCache>(gain_cache), rb) { }
+
+  DeterministicFMRefiner(const DeterministicFMRefiner&) = delete;
+  DeterministicFMRefiner(DeterministicFMRefiner&&) = delete;
+
+  DeterministicFMRefiner & operator= (const DeterministicFMRefiner &) = delete;
+  DeterministicFMRefiner & operator= (DeterministicFMRefiner &&) = delete;
+
+ private:
+  bool refineImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph,
+                  const vec<HypernodeID>& refinement_nodes,
+                  Metrics& best_metrics,
+                  double) final ;
+
+  void initializeImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph) final;
+
+  // ! Collects all border nodes and shuffles them with the seeded permutation
+  void collectSeedNodes(PartitionedHypergraph& phg, const vec<HypernodeID>& refinement_nodes);
+
+  // ! Applies the best prefixes of the searches in the order of their search IDs.
+  // ! The move sequence of a search is truncated at its first move that conflicts
+  // ! with a previously applied search or violates the balance constraint.
+  void applySearchResults(PartitionedHypergraph& phg, const size_t num_searches);
+
+  void resizeDataStructuresForCurrentK();
+
+  const HypernodeID _initial_num_nodes;
+  const Context& _context;
+  GainCache& _gain_cache;
+  PartitionID _current_k;
+  FMSharedData _shared_data;
+  GlobalRollback<GraphAndGainTypes> _global_rollback;
+  tbb::enumerable_thread_specific<LocalSearch> _ets_search;
+  std::mt19937 _prng;
+  utils::ParallelPermutation<HypernodeID> _permutation;
+  vec<HypernodeID> _border_nodes;
+  vec<vec<Move>> _search_moves;
+};
+
+}  // namespace mt_kahypar
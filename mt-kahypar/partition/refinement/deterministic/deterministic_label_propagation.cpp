@@ -292,45 +292,83 @@ namespace mt_kahypar {
   template<typename GraphAndGainTypes>
   std::pair<Gain, bool> DeterministicLabelPropagationRefiner<GraphAndGainTypes>::applyMovesByMaximalPrefixesInBlockPairs(PartitionedHypergraph& phg) {
     PartitionID k = current_k;
-    PartitionID max_key = k * k;
-    auto index = [&](PartitionID b1, PartitionID b2) { return b1 * k + b2; };
+    const size_t max_key = static_cast<size_t>(k) * k;
+    auto index = [&](PartitionID b1, PartitionID b2) { return static_cast<size_t>(b1) * k + b2; };
     auto get_key = [&](const Move& m) { return index(m.from, m.to); };
 
     const size_t num_moves = moves.size();
 
-    // aggregate moves by direction. not in-place because of counting sort.
-    // but it gives us the positions of the buckets right away
-    auto positions = parallel::counting_sort(moves, sorted_moves, max_key, get_key,
-                                             context.shared_memory.num_threads);
-
-    auto has_moves = [&](PartitionID p1, PartitionID p2) {
-      size_t direction = index(p1, p2);
-      return positions[direction + 1] != positions[direction];
-    };
-
-    vec<std::pair<PartitionID, PartitionID>> relevant_block_pairs;
-    vec<size_t> involvements(k, 0);
-    for (PartitionID p1 = 0; p1 < k; ++p1) {
-      for (PartitionID p2 = p1 + 1; p2 < k; ++p2) {
-        if (has_moves(p1, p2) || has_moves(p2, p1)) {
-          relevant_block_pairs.emplace_back(p1, p2);
-        }
-        // more involvements reduce slack --> only increment involvements if vertices are moved into that block
-        if (has_moves(p1, p2)) {
-          involvements[p2]++;
+    // aggregate moves by direction. direction_begins stores the first position of each
+    // direction with moves in sorted_moves (directions are ordered by key)
+    vec<size_t> direction_begins;
+    if (max_key <= num_moves) {
+      // not in-place because of counting sort. but it gives us the positions of the buckets right away
+      auto positions = parallel::counting_sort(moves, sorted_moves, max_key, get_key,
+                                               context.shared_memory.num_threads);
+      for (size_t direction = 0; direction < max_key; ++direction) {
+        if (positions[direction + 1] != positions[direction]) {
+          direction_begins.push_back(positions[direction]);
         }
-        if (has_moves(p2, p1)) {
-          involvements[p1]++;
+      }
+    } else {
+      // for large k, most of the k^2 directions have no moves. Counting sort and scanning
+      // all directions would dominate the running time => sort by key instead.
+      // Note that the order within a direction is fixed by the gain sort below.
+      tbb::parallel_for(UL(0), num_moves, [&](const size_t i) { sorted_moves[i] = moves[i]; });
+      tbb::parallel_sort(sorted_moves.begin(), sorted_moves.begin() + num_moves, [&](const Move& m1, const Move& m2) {
+        return get_key(m1) < get_key(m2);
+      });
+      for (size_t pos = 0; pos < num_moves; ++pos) {
+        if (pos == 0 || get_key(sorted_moves[pos]) != get_key(sorted_moves[pos - 1])) {
+          direction_begins.push_back(pos);
         }
       }
     }
+    const size_t num_directions = direction_begins.size();
+    direction_begins.push_back(num_moves);
 
-    // swap_prefix[index(p1,p2)] stores the first position of moves to revert out of the sequence of moves from p1 to p2
-    vec<size_t> swap_prefix(max_key, 0);
+    // group both directions of a block pair. since directions are ordered by key,
+    // direction p1 -> p2 precedes direction p2 -> p1 for p1 < p2.
+    vec<std::pair<size_t, size_t>> directions_by_block_pair(num_directions);
+    vec<size_t> involvements(k, 0);
+    for (size_t d = 0; d < num_directions; ++d) {
+      const Move& m = sorted_moves[direction_begins[d]];
+      directions_by_block_pair[d] = std::make_pair(index(std::min(m.from, m.to), std::max(m.from, m.to)), d);
+      // more involvements reduce slack --> only increment involvements if vertices are moved into that block
+      involvements[m.to]++;
+    }
+    std::sort(directions_by_block_pair.begin(), directions_by_block_pair.end());
+
+    struct BlockPairDirections {
+      PartitionID p1;
+      PartitionID p2;
+      size_t p1_to_p2;  // index of the direction or num_directions if there are no moves
+      size_t p2_to_p1;
+    };
+    vec<BlockPairDirections> relevant_block_pairs;
+    for (size_t i = 0; i < num_directions; ++i) {
+      const Move& m = sorted_moves[direction_begins[directions_by_block_pair[i].second]];
+      const size_t d = directions_by_block_pair[i].second;
+      if (m.from < m.to) {
+        relevant_block_pairs.push_back(BlockPairDirections { m.from, m.to, d, num_directions });
+      } else if (!relevant_block_pairs.empty() && relevant_block_pairs.back().p1 == m.to &&
+                 relevant_block_pairs.back().p2 == m.from) {
+        relevant_block_pairs.back().p2_to_p1 = d;
+      } else {
+        relevant_block_pairs.push_back(BlockPairDirections { m.to, m.from, num_directions, d });
+      }
+    }
+
+    // range of a direction in sorted_moves (empty, if the direction has no moves)
+    auto begin_of = [&](size_t d) { return d < num_directions ? direction_begins[d] : UL(0); };
+    auto end_of = [&](size_t d) { return d < num_directions ? direction_begins[d + 1] : UL(0); };
+
+    // swap_prefix[d] stores the first position of moves to revert out of the sequence of moves of direction d
+    vec<size_t> swap_prefix(num_directions, 0);
     tbb::parallel_for(size_t(0), relevant_block_pairs.size(), [&](size_t bp_index) {
       // sort both directions by gain (alternative: gain / weight?)
-      auto sort_by_gain_and_prefix_sum_node_weights = [&](PartitionID p1, PartitionID p2) {
-        size_t begin = positions[index(p1, p2)], end = positions[index(p1, p2) + 1];
+      auto sort_by_gain_and_prefix_sum_node_weights = [&](size_t d) {
+        size_t begin = begin_of(d), end = end_of(d);
         auto comp = [&](const Move& m1, const Move& m2) {
           return m1.gain > m2.gain || (m1.gain == m2.gain && m1.node < m2.node);
         };
@@ -342,12 +380,12 @@ namespace mt_kahypar {
                             cumulative_node_weights.begin() + begin, std::plus<>(), 0);
       };
 
-      PartitionID p1, p2;
-      std::tie(p1, p2) = relevant_block_pairs[bp_index];
+      const BlockPairDirections& bp = relevant_block_pairs[bp_index];
+      const PartitionID p1 = bp.p1, p2 = bp.p2;
       tbb::parallel_invoke([&] {
-        sort_by_gain_and_prefix_sum_node_weights(p1, p2);
+        sort_by_gain_and_prefix_sum_node_weights(bp.p1_to_p2);
       }, [&] {
-        sort_by_gain_and_prefix_sum_node_weights(p2, p1);
+        sort_by_gain_and_prefix_sum_node_weights(bp.p2_to_p1);
       });
 
       HypernodeWeight  budget_p1 = context.partition.max_part_weights[p1] - phg.partWeight(p1),
@@ -355,8 +393,8 @@ namespace mt_kahypar {
       HypernodeWeight  lb_p1 = -(budget_p1 /std::max(size_t(1), involvements[p1])),
                        ub_p2 = budget_p2 / std::max(size_t(1), involvements[p2]);
 
-      size_t p1_begin = positions[index(p1, p2)], p1_end = positions[index(p1, p2) + 1],
-             p2_begin = positions[index(p2, p1)], p2_end = positions[index(p2, p1) + 1];
+      size_t p1_begin = begin_of(bp.p1_to_p2), p1_end = end_of(bp.p1_to_p2),
+             p2_begin = begin_of(bp.p2_to_p1), p2_end = end_of(bp.p2_to_p1);
 
       auto best_prefix = findBestPrefixesRecursive(p1_begin, p1_end, p2_begin, p2_end,
                                                    p1_begin - 1, p2_begin - 1, lb_p1, ub_p2);
@@ -368,13 +406,17 @@ namespace mt_kahypar {
         // --> replace with starts of ranges (represents no moves applied)
         best_prefix = std::make_pair(p1_begin, p2_begin);
       }
-      swap_prefix[index(p1, p2)] = best_prefix.first;
-      swap_prefix[index(p2, p1)] = best_prefix.second;
+      if (bp.p1_to_p2 < num_directions) swap_prefix[bp.p1_to_p2] = best_prefix.first;
+      if (bp.p2_to_p1 < num_directions) swap_prefix[bp.p2_to_p1] = best_prefix.second;
     });
 
+    auto direction_of = [&](size_t pos) -> size_t {
+      return std::upper_bound(direction_begins.begin(), direction_begins.end(), pos) - direction_begins.begin() - 1;
+    };
+
     moves.clear();
     Gain actual_gain = applyMovesIf(phg, sorted_moves, num_moves, [&](size_t pos) {
-      if (pos < swap_prefix[index(sorted_moves[pos].from, sorted_moves[pos].to)]) {
+      if (pos < swap_prefix[direction_of(pos)]) {
         return true;
       } else {
         // save non-applied moves as backup, to try to apply them in a second step.
@@ -388,7 +430,7 @@ namespace mt_kahypar {
     bool revert_all = actual_gain < 0;
     if (revert_all) {
       actual_gain += applyMovesIf(phg, sorted_moves, num_moves, [&](size_t pos) {
-        if (pos < swap_prefix[index(sorted_moves[pos].from, sorted_moves[pos].to)]) {
+        if (pos < swap_prefix[direction_of(pos)]) {
           std::swap(sorted_moves[pos].from, sorted_moves[pos].to);
           return true;
         } else {
@@ -66,12 +66,29 @@ struct Subhypergraph {
   HypernodeWeight weight_of_block_1;
   vec<HyperedgeID> hes;
   size_t num_pins;
+  // ! Order-independent hash of the nodes and hyperedges of the region
+  // ! (only computed if r-flow-skip-unchanged-regions is enabled)
+  uint64_t fingerprint = 0;
 
   size_t numNodes() const {
     return nodes_of_block_0.size() + nodes_of_block_1.size();
   }
 };
 
+// Region grown around a block pair that also contains nodes of adjacent
+// blocks. We solve a sequence of flow problems on the block pairs of the region
+// (see r-flow-max-blocks-per-region).
+struct MultiwayRegion {
+  // ! Blocks of the region (the first two are the blocks of the search)
+  vec<PartitionID> blocks;
+  vec<HypernodeID> nodes;
+  size_t num_pins;
+
+  size_t numNodes() const {
+    return nodes.size();
+  }
+};
+
 inline std::ostream& operator<<(std::ostream& out, const Subhypergraph& sub_hg) {
   out << "[Nodes=" << sub_hg.numNodes()
       << ", Edges=" << sub_hg.hes.size()
@@ -31,8 +31,10 @@
 #include "tbb/concurrent_queue.h"
 
 #include "mt-kahypar/definitions.h"
+#include "mt-kahypar/parallel/parallel_prefix_sum.h"
 #include "mt-kahypar/parallel/stl/scalable_queue.h"
 #include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
+#include "mt-kahypar/utils/utilities.h"
 
 namespace mt_kahypar {
 
@@ -341,18 +343,32 @@ FlowProblem ParallelConstruction<GraphAndGainTypes>::constructOptimizedForLargeH
                                                                                 const PartitionID block_1,
                                                                                 vec<HypernodeID>& whfc_to_node) {
   ASSERT(block_0 != kInvalidPartition && block_1 != kInvalidPartition);
+  utils::Timer& timer = utils::Utilities::instance().getTimer(_context.utility_id);
   FlowProblem flow_problem;
   flow_problem.total_cut = 0;
   flow_problem.non_removable_cut = 0;
   _node_to_whfc.clear();
 
+  // The pins of the flow hypergraph are sorted by their hyperedge with a counting sort.
+  // All temporary buffers are members of the construction and only grow if a
+  // region exceeds the size of all previous regions.
+  const HyperedgeID max_hyperedges = sub_hg.hes.size();
+  timer.start_timer("flow_assembly_initialize", "Initialize", true);
   tbb::parallel_invoke([&]() {
     _he_to_whfc.clear();
-    _he_to_whfc.setMaxSize(sub_hg.hes.size());
+    _he_to_whfc.setMaxSize(max_hyperedges);
     tbb::parallel_for(UL(0), sub_hg.hes.size(), [&](const size_t i) {
       const HyperedgeID he = sub_hg.hes[i];
       _he_to_whfc[he] = i;
     });
+  }, [&] {
+    if ( _pin_offsets.size() < max_hyperedges + 1 ) {
+      _pin_offsets.resize(max_hyperedges + 1);
+      _pin_cursors.resize(max_hyperedges + 1);
+    }
+    tbb::parallel_for(UL(0), static_cast<size_t>(max_hyperedges) + 1, [&](const size_t i) {
+      _pin_offsets[i] = 0;
+    });
   }, [&] {
     whfc_to_node.resize(sub_hg.numNodes() + 2);
   }, [&] {
@@ -360,15 +376,20 @@ FlowProblem ParallelConstruction<GraphAndGainTypes>::constructOptimizedForLargeH
   }, [&] {
     _identical_nets.reset();
   });
+  timer.stop_timer("flow_assembly_initialize");
 
   if ( _context.refinement.flows.determine_distance_from_cut ) {
     _cut_hes.clear();
   }
 
-  // Add refinement nodes to flow network
-  const size_t num_buckets = _pins.numBuckets();
-  const HyperedgeID max_hyperedges = sub_hg.hes.size();
-  const size_t hes_per_bucket = max_hyperedges / num_buckets + (max_hyperedges % num_buckets != 0);
+  // Add refinement nodes to flow network and count the pins of each hyperedge
+  timer.start_timer("flow_assembly_count_pins", "Count Pins", true);
+  auto count_pins = [&](const HypernodeID hn) {
+    for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+      ASSERT(_he_to_whfc.get_if_contained(he) != nullptr);
+      __atomic_fetch_add(&_pin_offsets[_he_to_whfc[he] + 1], 1, __ATOMIC_RELAXED);
+    }
+  };
   tbb::parallel_invoke([&] {
     // Add source nodes
     flow_problem.source = whfc::Node(0);
@@ -380,11 +401,7 @@ FlowProblem ParallelConstruction<GraphAndGainTypes>::constructOptimizedForLargeH
       const whfc::Node u(1 + i);
       whfc_to_node[u] = hn;
       _flow_hg.nodeWeight(u) = whfc::NodeWeight(phg.nodeWeight(hn));
-      for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
-        ASSERT(_he_to_whfc.get_if_contained(he) != nullptr);
-        const HyperedgeID e = _he_to_whfc[he];
-        _pins.insert(e / hes_per_bucket, TmpPin { e, u, block_0 });
-      }
+      count_pins(hn);
     });
   }, [&] {
     // Add sink nodes
@@ -397,129 +414,147 @@ FlowProblem ParallelConstruction<GraphAndGainTypes>::constructOptimizedForLargeH
       const whfc::Node u(flow_problem.sink + 1 + i);
       whfc_to_node[u] = hn;
       _flow_hg.nodeWeight(u) = whfc::NodeWeight(phg.nodeWeight(hn));
-      for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
-        ASSERT(_he_to_whfc.get_if_contained(he) != nullptr);
-        const HyperedgeID e = _he_to_whfc[he];
-        _pins.insert(e / hes_per_bucket, TmpPin { e, u, block_1 });
-      }
+      count_pins(hn);
     });
   });
   flow_problem.weight_of_block_0 = _flow_hg.nodeWeight(flow_problem.source) + sub_hg.weight_of_block_0;
   flow_problem.weight_of_block_1 = _flow_hg.nodeWeight(flow_problem.sink) + sub_hg.weight_of_block_1;
+  timer.stop_timer("flow_assembly_count_pins");
+
+  // Prefix sum over the pin counts => _pin_offsets[e] is the first position
+  // of hyperedge e in the sorted pin list
+  timer.start_timer("flow_assembly_prefix_sum", "Prefix Sum", true);
+  parallel_prefix_sum(_pin_offsets.begin(), _pin_offsets.begin() + max_hyperedges + 1,
+    _pin_offsets.begin(), std::plus<HypernodeID>(), 0);
+  const HypernodeID num_tmp_pins = _pin_offsets[max_hyperedges];
+  if ( _sorted_pins.size() < num_tmp_pins ) {
+    _sorted_pins.resize(num_tmp_pins);
+  }
+  tbb::parallel_for(UL(0), static_cast<size_t>(max_hyperedges), [&](const size_t e) {
+    _pin_cursors[e] = _pin_offsets[e];
+  });
+  timer.stop_timer("flow_assembly_prefix_sum");
+
+  // Place each pin at the next free position of its hyperedge
+  timer.start_timer("flow_assembly_place_pins", "Place Pins", true);
+  auto place_pins = [&](const HypernodeID hn, const whfc::Node u, const PartitionID block) {
+    for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+      const HyperedgeID e = _he_to_whfc[he];
+      const HypernodeID pos = __atomic_fetch_add(&_pin_cursors[e], 1, __ATOMIC_RELAXED);
+      _sorted_pins[pos] = TmpPin { e, u, block };
+    }
+  };
+  tbb::parallel_invoke([&] {
+    tbb::parallel_for(UL(0), sub_hg.nodes_of_block_0.size(), [&](const size_t i) {
+      place_pins(sub_hg.nodes_of_block_0[i], whfc::Node(1 + i), block_0);
+    });
+  }, [&] {
+    tbb::parallel_for(UL(0), sub_hg.nodes_of_block_1.size(), [&](const size_t i) {
+      place_pins(sub_hg.nodes_of_block_1[i], whfc::Node(flow_problem.sink + 1 + i), block_1);
+    });
+  });
+  timer.stop_timer("flow_assembly_place_pins");
 
+  // Each CSR bucket covers a consecutive range of hyperedges. Thus, we know
+  // the exact number of hyperedges and pins of each bucket in advance.
+  timer.start_timer("flow_assembly_hyperedges", "Assemble Hyperedges", true);
   const HypernodeID max_pins = sub_hg.num_pins + max_hyperedges;
   _flow_hg.allocateHyperedgesAndPins(max_hyperedges, max_pins);
-  _flow_hg.setNumCSRBuckets(num_buckets);
-
-  _pins.doParallelForAllBuckets([&](const size_t idx) {
-    vec<TmpPin>& pins_of_bucket = _pins.getBucket(idx);
-    if ( pins_of_bucket.size() > 0 ) {
-      std::sort(pins_of_bucket.begin(), pins_of_bucket.end(),
-        [&](const TmpPin& lhs, const TmpPin& rhs ) {
-          return lhs.e < rhs.e || (lhs.e == rhs.e && lhs.pin < rhs.pin);
-        });
-
-      HyperedgeID last_he = kInvalidHyperedge;
-      size_t num_hes = 1;
-      size_t num_pins = 0;
-      for ( const TmpPin& pin : pins_of_bucket ) {
-        if ( pin.e != last_he ) {
-          ++num_hes;
-          last_he = pin.e;
-        }
-        ++num_pins;
+  _flow_hg.setNumCSRBuckets(NUM_CSR_BUCKETS);
+  const size_t step = max_hyperedges / NUM_CSR_BUCKETS + (max_hyperedges % NUM_CSR_BUCKETS != 0);
+  tbb::parallel_for(UL(0), NUM_CSR_BUCKETS, [&](const size_t idx) {
+    const size_t start = std::min(step * idx, static_cast<size_t>(max_hyperedges));
+    const size_t end = std::min(step * (idx + 1), static_cast<size_t>(max_hyperedges));
+    const size_t num_hes = end - start;
+    const size_t num_pins = _pin_offsets[end] - _pin_offsets[start] + num_hes;
+    _flow_hg.initializeCSRBucket(idx, num_hes, num_pins);
+
+    whfc::Hyperedge current_he(0);
+    size_t pin_idx = 0;
+    vec<whfc::Node>& tmp_pins = _tmp_pins.local();
+    for ( size_t e = start; e < end; ++e ) {
+      const HyperedgeID he = sub_hg.hes[e];
+      const auto pins_begin = _sorted_pins.begin() + _pin_offsets[e];
+      const auto pins_end = _sorted_pins.begin() + _pin_offsets[e + 1];
+      if ( pins_begin == pins_end || FlowNetworkConstruction::dropHyperedge(phg, he, block_0, block_1) ) {
+        continue;
       }
-      num_pins += num_hes;
-      _flow_hg.initializeCSRBucket(idx, num_hes, num_pins);
-
-      whfc::Hyperedge current_he(0);
-      size_t pin_idx = 0;
-      vec<whfc::Node>& tmp_pins = _tmp_pins.local();
-      size_t start_idx = 0;
-      last_he = pins_of_bucket[start_idx].e;
+
+      // The position of a pin depends on the thread that placed it, so we
+      // sort the pins to obtain a unique order for the identical net detection
+      std::sort(pins_begin, pins_end, [&](const TmpPin& lhs, const TmpPin& rhs) {
+        return lhs.pin < rhs.pin;
+      });
       HypernodeID pin_count_in_block_0 = 0;
       HypernodeID pin_count_in_block_1 = 0;
-      auto add_hyperedge = [&](const size_t end_idx) {
-        ASSERT(start_idx < end_idx);
-        tmp_pins.clear();
-        const HyperedgeID he = sub_hg.hes[last_he];
-        if ( !FlowNetworkConstruction::dropHyperedge(phg, he, block_0, block_1) ) {
-          const HyperedgeWeight he_weight = FlowNetworkConstruction::capacity(phg, _context, he, block_0, block_1);
-          const HypernodeID actual_pin_count_block_0 = phg.pinCountInPart(he, block_0);
-          const HypernodeID actual_pin_count_block_1 = phg.pinCountInPart(he, block_1);
-          bool connect_to_source = FlowNetworkConstruction::connectToSource(phg, he, block_0, block_1);
-          bool connect_to_sink = FlowNetworkConstruction::connectToSink(phg, he, block_0, block_1);
-          connect_to_source |= pin_count_in_block_0 < actual_pin_count_block_0;
-          connect_to_sink |= pin_count_in_block_1 < actual_pin_count_block_1;
-          if ( ( actual_pin_count_block_0 > 0 && actual_pin_count_block_1 > 0 ) ||
-                 FlowNetworkConstruction::isCut(phg, he, block_0, block_1) ) {
-            __atomic_fetch_add(&flow_problem.total_cut, he_weight, __ATOMIC_RELAXED);
-          }
+      for ( auto it = pins_begin; it != pins_end; ++it ) {
+        pin_count_in_block_0 += it->block == block_0;
+        pin_count_in_block_1 += it->block == block_1;
+      }
 
-          if ( connect_to_source && connect_to_sink ) {
-            // Hyperedge is connected to source and sink which means we can not remove it
-            // from the cut with the current flow problem => remove he from flow problem
-            __atomic_fetch_add(&flow_problem.non_removable_cut, he_weight, __ATOMIC_RELAXED);
-          } else {
-            // Add hyperedge to flow network and configure source and sink
-            size_t hash = 0;
-            if ( connect_to_source ) {
-              tmp_pins.push_back(flow_problem.source);
-              hash += kahypar::math::hash(flow_problem.source);
-            } else if ( connect_to_sink ) {
-              tmp_pins.push_back(flow_problem.sink);
-              hash += kahypar::math::hash(flow_problem.sink);
-            }
-            for ( size_t i = start_idx; i < end_idx; ++i ) {
-              tmp_pins.push_back(pins_of_bucket[i].pin);
-              hash += kahypar::math::hash(pins_of_bucket[i].pin);
-            }
+      tmp_pins.clear();
+      const HyperedgeWeight he_weight = FlowNetworkConstruction::capacity(phg, _context, he, block_0, block_1);
+      const HypernodeID actual_pin_count_block_0 = phg.pinCountInPart(he, block_0);
+      const HypernodeID actual_pin_count_block_1 = phg.pinCountInPart(he, block_1);
+      bool connect_to_source = FlowNetworkConstruction::connectToSource(phg, he, block_0, block_1);
+      bool connect_to_sink = FlowNetworkConstruction::connectToSink(phg, he, block_0, block_1);
+      connect_to_source |= pin_count_in_block_0 < actual_pin_count_block_0;
+      connect_to_sink |= pin_count_in_block_1 < actual_pin_count_block_1;
+      if ( ( actual_pin_count_block_0 > 0 && actual_pin_count_block_1 > 0 ) ||
+             FlowNetworkConstruction::isCut(phg, he, block_0, block_1) ) {
+        __atomic_fetch_add(&flow_problem.total_cut, he_weight, __ATOMIC_RELAXED);
+      }
 
-            if ( tmp_pins.size() > 1 ) {
-              const TmpHyperedge identical_net = _identical_nets.get(hash, tmp_pins);
-              if ( identical_net.e == whfc::invalidHyperedge ) {
-                const size_t pin_start = pin_idx;
-                const size_t pin_end = pin_start + tmp_pins.size();
-                for ( const whfc::Node& pin : tmp_pins ) {
-                  _flow_hg.addPin(pin, idx, pin_idx++);
-                }
-                TmpHyperedge tmp_e { hash, idx, current_he++ };
-                if ( _context.refinement.flows.determine_distance_from_cut &&
-                    actual_pin_count_block_0 > 0 && actual_pin_count_block_1 > 0 ) {
-                  _cut_hes.push_back(tmp_e);
-                }
-                _flow_hg.finishHyperedge(tmp_e.e, he_weight, idx, pin_start, pin_end);
-                _identical_nets.add(tmp_e);
-              } else {
-                // Current hyperedge is identical to an already added
-                __atomic_fetch_add(&_flow_hg.capacity(identical_net.bucket, identical_net.e), he_weight, __ATOMIC_RELAXED);
-              }
+      if ( connect_to_source && connect_to_sink ) {
+        // Hyperedge is connected to source and sink which means we can not remove it
+        // from the cut with the current flow problem => remove he from flow problem
+        __atomic_fetch_add(&flow_problem.non_removable_cut, he_weight, __ATOMIC_RELAXED);
+      } else {
+        // Add hyperedge to flow network and configure source and sink
+        size_t hash = 0;
+        if ( connect_to_source ) {
+          tmp_pins.push_back(flow_problem.source);
+          hash += kahypar::math::hash(flow_problem.source);
+        } else if ( connect_to_sink ) {
+          tmp_pins.push_back(flow_problem.sink);
+          hash += kahypar::math::hash(flow_problem.sink);
+        }
+        for ( auto it = pins_begin; it != pins_end; ++it ) {
+          tmp_pins.push_back(it->pin);
+          hash += kahypar::math::hash(it->pin);
+        }
+
+        if ( tmp_pins.size() > 1 ) {
+          const TmpHyperedge identical_net = _identical_nets.get(hash, tmp_pins);
+          if ( identical_net.e == whfc::invalidHyperedge ) {
+            const size_t pin_start = pin_idx;
+            const size_t pin_end = pin_start + tmp_pins.size();
+            for ( const whfc::Node& pin : tmp_pins ) {
+              _flow_hg.addPin(pin, idx, pin_idx++);
+            }
+            TmpHyperedge tmp_e { hash, idx, current_he++ };
+            if ( _context.refinement.flows.determine_distance_from_cut &&
+                actual_pin_count_block_0 > 0 && actual_pin_count_block_1 > 0 ) {
+              _cut_hes.push_back(tmp_e);
             }
+            _flow_hg.finishHyperedge(tmp_e.e, he_weight, idx, pin_start, pin_end);
+            _identical_nets.add(tmp_e);
+          } else {
+            // Current hyperedge is identical to an already added
+            __atomic_fetch_add(&_flow_hg.capacity(identical_net.bucket, identical_net.e), he_weight, __ATOMIC_RELAXED);
           }
         }
-      };
-      for ( size_t i = 0; i < pins_of_bucket.size(); ++i ) {
-        if ( last_he != pins_of_bucket[i].e ) {
-          add_hyperedge(i);
-          start_idx = i;
-          last_he = pins_of_bucket[i].e;
-          pin_count_in_block_0 = 0;
-          pin_count_in_block_1 = 0;
-        }
-        pin_count_in_block_0 += pins_of_bucket[i].block == block_0;
-        pin_count_in_block_1 += pins_of_bucket[i].block == block_1;
       }
-      add_hyperedge(pins_of_bucket.size());
-    } else {
-      _flow_hg.initializeCSRBucket(idx, 0, 0);
     }
-    _pins.clear(idx);
   });
+  timer.stop_timer("flow_assembly_hyperedges");
 
-  tbb::parallel_for(UL(0), num_buckets, [&](const size_t idx) {
+  timer.start_timer("flow_assembly_finalize", "Finalize CSR Buckets", true);
+  tbb::parallel_for(UL(0), NUM_CSR_BUCKETS, [&](const size_t idx) {
     _flow_hg.finalizeCSRBucket(idx);
   });
   _flow_hg.finalizeHyperedges();
+  timer.stop_timer("flow_assembly_finalize");
 
   return flow_problem;
 }
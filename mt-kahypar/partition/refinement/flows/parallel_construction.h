@@ -36,7 +36,6 @@
 #include "mt-kahypar/datastructures/sparse_map.h"
 #include "mt-kahypar/datastructures/concurrent_flat_map.h"
 #include "mt-kahypar/datastructures/thread_safe_fast_reset_flag_array.h"
-#include "mt-kahypar/datastructures/concurrent_bucket_map.h"
 #include "mt-kahypar/partition/refinement/flows/i_flow_refiner.h"
 #include "mt-kahypar/partition/refinement/flows/flow_hypergraph_builder.h"
 #include "mt-kahypar/parallel/stl/zero_allocator.h"
@@ -124,7 +123,9 @@ class ParallelConstruction {
     _visited_hns(),
     _tmp_pins(),
     _cut_hes(),
-    _pins(),
+    _pin_offsets(),
+    _pin_cursors(),
+    _sorted_pins(),
     _he_to_whfc(),
     _identical_nets(num_hyperedges, flow_hg, context) { }
 
@@ -180,7 +181,10 @@ class ParallelConstruction {
   tbb::enumerable_thread_specific<vec<whfc::Node>> _tmp_pins;
   tbb::concurrent_vector<TmpHyperedge> _cut_hes;
 
-  ds::ConcurrentBucketMap<TmpPin> _pins;
+  // ! Buffers of the counting sort that sorts the pins by their hyperedge
+  vec<HypernodeID> _pin_offsets;
+  vec<HypernodeID> _pin_cursors;
+  vec<TmpPin> _sorted_pins;
   ds::ConcurrentFlatMap<HyperedgeID, HyperedgeID> _he_to_whfc;
 
   DynamicIdenticalNetDetection _identical_nets;
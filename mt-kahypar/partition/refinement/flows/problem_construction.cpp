@@ -33,6 +33,7 @@
 
 #include "mt-kahypar/definitions.h"
 #include "mt-kahypar/partition/mapping/target_graph.h"
+#include "mt-kahypar/utils/hash.h"
 
 namespace mt_kahypar {
 
@@ -49,9 +50,9 @@ void ProblemConstruction<TypeTraits>::BFSData::reset() {
   queue_weight_block_1 = 0;
   lock_queue = false;
   clearQueue();
-  std::fill(visited_hn.begin(), visited_hn.end(), false);
-  std::fill(visited_he.begin(), visited_he.end(), false);
-  std::fill(contained_hes.begin(), contained_hes.end(), false);
+  visited_hn.clear();
+  visited_he.clear();
+  contained_hes.clear();
   std::fill(locked_blocks.begin(), locked_blocks.end(), false);
 }
 
@@ -71,9 +72,9 @@ void ProblemConstruction<TypeTraits>::BFSData::add_pins_of_hyperedge_to_queue(
   const HypernodeWeight max_weight_block_0,
   const HypernodeWeight max_weight_block_1) {
   if ( current_distance <= max_bfs_distance && !lock_queue ) {
-    if ( !visited_he[he] ) {
+    if ( !visited_he.contains(he) ) {
       for ( const HypernodeID& pin : phg.pins(he) ) {
-        if ( !visited_hn[pin] ) {
+        if ( !visited_hn.contains(pin) ) {
           const PartitionID block = phg.partID(pin);
           const bool is_block_0 = blocks.i == block;
           const bool is_block_1 = blocks.j == block;
@@ -135,8 +136,10 @@ Subhypergraph ProblemConstruction<TypeTraits>::construct(const SearchID search_i
     HypernodeID hn = bfs.pop_hypernode();
     PartitionID block = phg.partID(hn);
     const bool is_block_contained = block == sub_hg.block_0 || block == sub_hg.block_1;
-    if ( is_block_contained && !bfs.locked_blocks[block] ) {
-      const bool is_fixed = phg.isFixed(hn);
+    const bool is_fixed = phg.isFixed(hn);
+    // Fixed vertices are never moved, so they do not need an owner
+    if ( is_block_contained && !bfs.locked_blocks[block] &&
+         ( is_fixed || acquireNode(phg, hn, block, search_id) ) ) {
       // We do not add fixed vertices to the flow problem, but still
       // expand the BFS to its neighbors
       if ( !is_fixed ) {
@@ -155,7 +158,7 @@ Subhypergraph ProblemConstruction<TypeTraits>::construct(const SearchID search_i
       for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
         bfs.add_pins_of_hyperedge_to_queue(he, phg, max_bfs_distance,
           max_weight_block_0, max_weight_block_1);
-        if ( !is_fixed && !bfs.contained_hes[phg.uniqueEdgeID(he)] ) {
+        if ( !is_fixed && !bfs.contained_hes.contains(phg.uniqueEdgeID(he)) ) {
           sub_hg.hes.push_back(he);
           bfs.contained_hes[phg.uniqueEdgeID(he)] = true;
         }
@@ -166,6 +169,9 @@ Subhypergraph ProblemConstruction<TypeTraits>::construct(const SearchID search_i
       bfs.swap_with_next_queue();
     }
   }
+  if ( _context.refinement.flows.skip_unchanged_regions ) {
+    sub_hg.fingerprint = computeFingerprint(phg, sub_hg);
+  }
   DBG << "Search ID:" << search_id << "-" << sub_hg;
 
   // Check if all touched hyperedges are contained in subhypergraph
@@ -216,6 +222,217 @@ Subhypergraph ProblemConstruction<TypeTraits>::construct(const SearchID search_i
   return sub_hg;
 }
 
+template<typename TypeTraits>
+MultiwayRegion ProblemConstruction<TypeTraits>::constructMultiwayRegion(const SearchID search_id,
+                                                                        QuotientGraph<TypeTraits>& quotient_graph,
+                                                                        const PartitionedHypergraph& phg) {
+  MultiwayRegion region;
+  region.blocks = quotient_graph.blocksOfRegion(
+    search_id, _context.refinement.flows.max_blocks_per_region);
+  region.num_pins = 0;
+  BFSData& bfs = _local_bfs.local();
+  bfs.reset();
+  bfs.blocks = quotient_graph.getBlockPair(search_id);
+  const size_t max_bfs_distance = _context.refinement.flows.max_bfs_distance;
+
+  // A block of the region can contribute at most as much weight as the other
+  // blocks of the region are able to absorb. Blocks that are not part of the
+  // region are locked such that the BFS never visits them.
+  const size_t num_blocks = region.blocks.size();
+  size_t num_unlocked_blocks = num_blocks;
+  vec<HypernodeWeight> max_weights(num_blocks, 0);
+  vec<HypernodeWeight> weights(num_blocks, 0);
+  std::fill(bfs.locked_blocks.begin(), bfs.locked_blocks.end(), true);
+  auto lock_block = [&](const PartitionID block) {
+    if ( !bfs.locked_blocks[block] ) {
+      bfs.locked_blocks[block] = true;
+      --num_unlocked_blocks;
+    }
+  };
+  for ( size_t i = 0; i < num_blocks; ++i ) {
+    bfs.locked_blocks[region.blocks[i]] = false;
+    for ( size_t j = 0; j < num_blocks; ++j ) {
+      if ( i != j ) {
+        const PartitionID other = region.blocks[j];
+        const HypernodeWeight max_weight = _scaling *
+          _context.partition.perfect_balance_part_weights[other] - phg.partWeight(other);
+        max_weights[i] = std::max(max_weights[i], max_weight);
+      }
+    }
+  }
+  for ( size_t i = 0; i < num_blocks; ++i ) {
+    if ( max_weights[i] <= 0 ) {
+      lock_block(region.blocks[i]);
+    }
+  }
+
+  auto add_pins_of_hyperedge_to_queue = [&](const HyperedgeID& he) {
+    if ( bfs.current_distance <= max_bfs_distance && !bfs.visited_he.contains(he) ) {
+      for ( const HypernodeID& pin : phg.pins(he) ) {
+        if ( !bfs.visited_hn.contains(pin) ) {
+          if ( !bfs.locked_blocks[phg.partID(pin)] ) {
+            bfs.next_queue.push(pin);
+          }
+          bfs.visited_hn[pin] = true;
+        }
+      }
+      bfs.visited_he[he] = true;
+    }
+  };
+
+  // We initialize the BFS with all cut hyperedges running
+  // between the involved block associated with the search
+  bfs.clearQueue();
+  quotient_graph.doForAllCutHyperedgesOfSearch(search_id, add_pins_of_hyperedge_to_queue);
+  bfs.swap_with_next_queue();
+
+  // BFS
+  while ( !bfs.is_empty() && num_unlocked_blocks > 0 ) {
+    const HypernodeID hn = bfs.pop_hypernode();
+    const PartitionID block = phg.partID(hn);
+    const bool is_fixed = phg.isFixed(hn);
+    if ( !bfs.locked_blocks[block] &&
+         ( is_fixed || acquireNode(phg, hn, block, search_id) ) ) {
+      if ( !is_fixed ) {
+        const size_t idx = std::find(region.blocks.begin(),
+          region.blocks.end(), block) - region.blocks.begin();
+        ASSERT(idx < num_blocks);
+        region.nodes.push_back(hn);
+        region.num_pins += phg.nodeDegree(hn);
+        weights[idx] += phg.nodeWeight(hn);
+        if ( weights[idx] >= max_weights[idx] ) {
+          lock_block(block);
+        }
+        if ( region.num_pins >= _context.refinement.flows.max_num_pins ) {
+          for ( const PartitionID& region_block : region.blocks ) {
+            lock_block(region_block);
+          }
+        }
+      }
+
+      // Push all neighbors of the added vertex into the queue
+      for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+        add_pins_of_hyperedge_to_queue(he);
+      }
+    }
+
+    if ( bfs.is_empty() ) {
+      bfs.swap_with_next_queue();
+    }
+  }
+  DBG << "Search ID:" << search_id << "- Multiway Region [ Nodes =" << region.numNodes()
+      << ", Pins =" << region.num_pins << ", Blocks =" << region.blocks.size() << "]";
+
+  return region;
+}
+
+template<typename TypeTraits>
+Subhypergraph ProblemConstruction<TypeTraits>::extractBlockPair(const PartitionedHypergraph& phg,
+                                                                const MultiwayRegion& region,
+                                                                const PartitionID block_0,
+                                                                const PartitionID block_1) {
+  ASSERT(block_0 < block_1);
+  Subhypergraph sub_hg;
+  sub_hg.block_0 = block_0;
+  sub_hg.block_1 = block_1;
+  sub_hg.weight_of_block_0 = 0;
+  sub_hg.weight_of_block_1 = 0;
+  sub_hg.num_pins = 0;
+  BFSData& bfs = _local_bfs.local();
+  bfs.contained_hes.clear();
+  for ( const HypernodeID& hn : region.nodes ) {
+    // Flow problems solved before on the same region may have moved the node
+    const PartitionID block = phg.partID(hn);
+    if ( block == block_0 ) {
+      sub_hg.nodes_of_block_0.push_back(hn);
+      sub_hg.weight_of_block_0 += phg.nodeWeight(hn);
+    } else if ( block == block_1 ) {
+      sub_hg.nodes_of_block_1.push_back(hn);
+      sub_hg.weight_of_block_1 += phg.nodeWeight(hn);
+    } else {
+      continue;
+    }
+    sub_hg.num_pins += phg.nodeDegree(hn);
+
+    for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+      if ( !bfs.contained_hes.contains(phg.uniqueEdgeID(he)) ) {
+        sub_hg.hes.push_back(he);
+        bfs.contained_hes[phg.uniqueEdgeID(he)] = true;
+      }
+    }
+  }
+  if ( _context.refinement.flows.skip_unchanged_regions ) {
+    sub_hg.fingerprint = computeFingerprint(phg, sub_hg);
+  }
+  return sub_hg;
+}
+
+template<typename TypeTraits>
+Subhypergraph ProblemConstruction<TypeTraits>::shrinkRegion(const PartitionedHypergraph& phg,
+                                                            const Subhypergraph& sub_hg,
+                                                            const double fraction) {
+  Subhypergraph shrunk_hg;
+  shrunk_hg.block_0 = sub_hg.block_0;
+  shrunk_hg.block_1 = sub_hg.block_1;
+  shrunk_hg.weight_of_block_0 = 0;
+  shrunk_hg.weight_of_block_1 = 0;
+  shrunk_hg.num_pins = 0;
+  BFSData& bfs = _local_bfs.local();
+  bfs.contained_hes.clear();
+  auto add_nodes = [&](const vec<HypernodeID>& nodes,
+                       const HypernodeWeight max_weight,
+                       vec<HypernodeID>& shrunk_nodes,
+                       HypernodeWeight& weight) {
+    for ( const HypernodeID& hn : nodes ) {
+      if ( weight >= max_weight ) {
+        break;
+      }
+      shrunk_nodes.push_back(hn);
+      weight += phg.nodeWeight(hn);
+      shrunk_hg.num_pins += phg.nodeDegree(hn);
+      for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+        if ( !bfs.contained_hes.contains(phg.uniqueEdgeID(he)) ) {
+          shrunk_hg.hes.push_back(he);
+          bfs.contained_hes[phg.uniqueEdgeID(he)] = true;
+        }
+      }
+    }
+  };
+  add_nodes(sub_hg.nodes_of_block_0, fraction * sub_hg.weight_of_block_0,
+    shrunk_hg.nodes_of_block_0, shrunk_hg.weight_of_block_0);
+  add_nodes(sub_hg.nodes_of_block_1, fraction * sub_hg.weight_of_block_1,
+    shrunk_hg.nodes_of_block_1, shrunk_hg.weight_of_block_1);
+  return shrunk_hg;
+}
+
+template<typename TypeTraits>
+void ProblemConstruction<TypeTraits>::releaseNodes(const SearchID search_id,
+                                                   const Subhypergraph& sub_hg) {
+  if ( !_node_owner.empty() ) {
+    for ( const HypernodeID& hn : sub_hg.nodes_of_block_0 ) {
+      ASSERT(_node_owner[hn] == search_id);
+      _node_owner[hn].store(QuotientGraph<TypeTraits>::INVALID_SEARCH_ID);
+    }
+    for ( const HypernodeID& hn : sub_hg.nodes_of_block_1 ) {
+      ASSERT(_node_owner[hn] == search_id);
+      _node_owner[hn].store(QuotientGraph<TypeTraits>::INVALID_SEARCH_ID);
+    }
+  }
+  unused(search_id);
+}
+
+template<typename TypeTraits>
+void ProblemConstruction<TypeTraits>::releaseNodes(const SearchID search_id,
+                                                   const MultiwayRegion& region) {
+  if ( !_node_owner.empty() ) {
+    for ( const HypernodeID& hn : region.nodes ) {
+      ASSERT(_node_owner[hn] == search_id);
+      _node_owner[hn].store(QuotientGraph<TypeTraits>::INVALID_SEARCH_ID);
+    }
+  }
+  unused(search_id);
+}
+
 template<typename TypeTraits>
 void ProblemConstruction<TypeTraits>::changeNumberOfBlocks(const PartitionID new_k) {
   ASSERT(new_k == _context.partition.k);
@@ -226,6 +443,53 @@ void ProblemConstruction<TypeTraits>::changeNumberOfBlocks(const PartitionID new
   }
 }
 
+template<typename TypeTraits>
+uint64_t ProblemConstruction<TypeTraits>::computeFingerprint(const PartitionedHypergraph& phg,
+                                                             const Subhypergraph& sub_hg) const {
+  using namespace hashing::integer;
+  // The BFS visits the region in random order. Therefore, we sum up the hashes
+  // of all elements such that the fingerprint does not depend on that order.
+  uint64_t fingerprint = combine64(hash64(sub_hg.block_0), hash64(sub_hg.block_1));
+  // The part weights determine the maximum block weights of the flow problem
+  // and therefore whether or not a balanced cut exists.
+  fingerprint = combine64(fingerprint, combine64(
+    hash64(static_cast<uint64_t>(phg.partWeight(sub_hg.block_0))),
+    hash64_2(static_cast<uint64_t>(phg.partWeight(sub_hg.block_1)))));
+  for ( const HypernodeID& hn : sub_hg.nodes_of_block_0 ) {
+    fingerprint += hash64(hn);
+  }
+  for ( const HypernodeID& hn : sub_hg.nodes_of_block_1 ) {
+    fingerprint += hash64_2(hn);
+  }
+  // The pin counts of the hyperedges in both blocks also capture moves
+  // of pins that are not part of the region, but are contracted into the
+  // source or sink of the flow network.
+  for ( const HyperedgeID& he : sub_hg.hes ) {
+    const uint64_t pin_counts =
+      (static_cast<uint64_t>(phg.pinCountInPart(he, sub_hg.block_0)) << 32) |
+      static_cast<uint64_t>(phg.pinCountInPart(he, sub_hg.block_1));
+    fingerprint += combine64(combine64(hash64(phg.uniqueEdgeID(he)),
+      hash64_2(pin_counts)), hash64(phg.connectivity(he)));
+  }
+  return fingerprint == 0 ? 1 : fingerprint;
+}
+
+template<typename TypeTraits>
+void ProblemConstruction<TypeTraits>::memoryConsumption(utils::MemoryTreeNode* parent) const {
+  ASSERT(parent);
+  utils::MemoryTreeNode* construction_node = parent->addChild("Problem Construction");
+  utils::MemoryTreeNode* visited_node = construction_node->addChild("Visited Nodes and Hyperedges");
+  utils::MemoryTreeNode* locked_blocks_node = construction_node->addChild("Locked Blocks");
+  for ( const BFSData& data : _local_bfs ) {
+    visited_node->updateSize(data.visited_hn.size_in_bytes() +
+      data.visited_he.size_in_bytes() + data.contained_hes.size_in_bytes());
+    locked_blocks_node->updateSize(data.locked_blocks.capacity() * sizeof(bool));
+  }
+  if ( !_node_owner.empty() ) {
+    construction_node->addChild("Node Ownership", sizeof(CAtomic<SearchID>) * _node_owner.size());
+  }
+}
+
 template<typename TypeTraits>
 MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE bool ProblemConstruction<TypeTraits>::isMaximumProblemSizeReached(
   const Subhypergraph& sub_hg,
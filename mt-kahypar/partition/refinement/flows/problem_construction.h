@@ -35,6 +35,7 @@
 #include "mt-kahypar/parallel/stl/scalable_vector.h"
 #include "mt-kahypar/parallel/stl/scalable_queue.h"
 #include "mt-kahypar/parallel/atomic_wrapper.h"
+#include "mt-kahypar/utils/memory_tree.h"
 
 namespace mt_kahypar {
 
@@ -48,17 +49,17 @@ class ProblemConstruction {
   /**
    * Contains data required to grow two region around
    * the cut of two blocks of the partition.
+   * The visited nodes and hyperedges are stored in hash sets, which
+   * grow with the size of the region and can be reset in constant time.
    */
   struct BFSData {
-    explicit BFSData(const HypernodeID num_nodes,
-                     const HyperedgeID num_edges,
-                     const PartitionID k) :
+    explicit BFSData(const PartitionID k) :
       current_distance(0),
       queue(),
       next_queue(),
-      visited_hn(num_nodes, false),
-      visited_he(num_edges, false),
-      contained_hes(num_edges, false),
+      visited_hn(),
+      visited_he(),
+      contained_hes(),
       locked_blocks(k, false),
       queue_weight_block_0(0),
       queue_weight_block_1(0),
@@ -95,9 +96,9 @@ class ProblemConstruction {
     size_t current_distance;
     parallel::scalable_queue<HypernodeID> queue;
     parallel::scalable_queue<HypernodeID> next_queue;
-    vec<bool> visited_hn;
-    vec<bool> visited_he;
-    vec<bool> contained_hes;
+    ds::DynamicFlatMap<HypernodeID, bool> visited_hn;
+    ds::DynamicFlatMap<HyperedgeID, bool> visited_he;
+    ds::DynamicFlatMap<HyperedgeID, bool> contained_hes;
     vec<bool> locked_blocks;
     HypernodeWeight queue_weight_block_0;
     HypernodeWeight queue_weight_block_1;
@@ -111,15 +112,19 @@ class ProblemConstruction {
     _context(context),
     _scaling(1.0 + _context.refinement.flows.alpha *
       std::min(0.05, _context.partition.epsilon)),
-    _num_hypernodes(num_hypernodes),
-    _num_hyperedges(num_hyperedges),
+    _node_owner(),
     _local_bfs([&] {
         // If the number of blocks changes, BFSData needs to be initialized
         // differently. Thus we use a lambda that reads the current number of
         // blocks from the context
         return constructBFSData();
       }
-    ) { }
+    ) {
+    unused(num_hyperedges);
+    if ( _context.refinement.flows.disjoint_regions ) {
+      _node_owner.assign(num_hypernodes, CAtomic<SearchID>(QuotientGraph<TypeTraits>::INVALID_SEARCH_ID));
+    }
+  }
 
   ProblemConstruction(const ProblemConstruction&) = delete;
   ProblemConstruction(ProblemConstruction&&) = delete;
@@ -131,11 +136,64 @@ class ProblemConstruction {
                           QuotientGraph<TypeTraits>& quotient_graph,
                           const PartitionedHypergraph& phg);
 
+  // ! Grows a region around the cut of the block pair of the corresponding search
+  // ! that also contains nodes of adjacent blocks (see QuotientGraph::blocksOfRegion(...))
+  MultiwayRegion constructMultiwayRegion(const SearchID search_id,
+                                         QuotientGraph<TypeTraits>& quotient_graph,
+                                         const PartitionedHypergraph& phg);
+
+  // ! Returns the subhypergraph induced by all nodes of the region that are
+  // ! currently assigned to block_0 or block_1. This only scans the region
+  // ! and is much cheaper than growing a new region.
+  Subhypergraph extractBlockPair(const PartitionedHypergraph& phg,
+                                 const MultiwayRegion& region,
+                                 const PartitionID block_0,
+                                 const PartitionID block_1);
+
+  // ! Returns the subhypergraph induced by the nodes of each block that are
+  // ! closest to the cut such that it contains roughly the given fraction of the
+  // ! weight of each block. The nodes of a region are stored in BFS order.
+  Subhypergraph shrinkRegion(const PartitionedHypergraph& phg,
+                             const Subhypergraph& sub_hg,
+                             const double fraction);
+
+  // ! Releases the ownership of all nodes contained in the region of the
+  // ! corresponding search (only required if r-flow-disjoint-regions is enabled)
+  void releaseNodes(const SearchID search_id, const Subhypergraph& sub_hg);
+
+  void releaseNodes(const SearchID search_id, const MultiwayRegion& region);
+
   void changeNumberOfBlocks(const PartitionID new_k);
 
+  void memoryConsumption(utils::MemoryTreeNode* parent) const;
+
  private:
+  uint64_t computeFingerprint(const PartitionedHypergraph& phg,
+                              const Subhypergraph& sub_hg) const;
+
+  // ! Returns true, if the node is not part of the region of another search.
+  // ! Another search may have moved the node before we acquired it, which is
+  // ! why we check again if the node is still contained in the expected block.
+  bool acquireNode(const PartitionedHypergraph& phg,
+                   const HypernodeID hn,
+                   const PartitionID block,
+                   const SearchID search_id) {
+    if ( _node_owner.empty() ) {
+      return true;
+    }
+    SearchID expected = QuotientGraph<TypeTraits>::INVALID_SEARCH_ID;
+    if ( _node_owner[hn].compare_exchange_strong(expected, search_id) ) {
+      if ( phg.partID(hn) == block ) {
+        return true;
+      }
+      _node_owner[hn].store(QuotientGraph<TypeTraits>::INVALID_SEARCH_ID);
+      return false;
+    }
+    return expected == search_id;
+  }
+
   BFSData constructBFSData() const {
-    return BFSData(_num_hypernodes, _num_hyperedges, _context.partition.k);
+    return BFSData(_context.partition.k);
   }
 
   MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE bool isMaximumProblemSizeReached(
@@ -146,8 +204,10 @@ class ProblemConstruction {
 
   const Context& _context;
   double _scaling;
-  HypernodeID _num_hypernodes;
-  HyperedgeID _num_hyperedges;
+
+  // ! Search whose region contains the node
+  // ! (only initialized if r-flow-disjoint-regions is enabled)
+  vec<CAtomic<SearchID>> _node_owner;
 
   // ! Contains data required for BFS construction algorithm
   tbb::enumerable_thread_specific<BFSData> _local_bfs;
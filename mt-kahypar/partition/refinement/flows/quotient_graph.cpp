@@ -52,13 +52,16 @@ void QuotientGraph<TypeTraits>::QuotientGraphEdge::reset() {
   is_in_queue.store(false, std::memory_order_relaxed);
   num_cut_hes.store(0, std::memory_order_relaxed);
   cut_he_weight.store(0, std::memory_order_relaxed);
+  unsuccessful_region.store(0, std::memory_order_relaxed);
 }
 
 template<typename TypeTraits>
 bool QuotientGraph<TypeTraits>::ActiveBlockSchedulingRound::popBlockPairFromQueue(BlockPair& blocks) {
   blocks.i = kInvalidPartition;
   blocks.j = kInvalidPartition;
-  if ( _unscheduled_blocks.try_pop(blocks) ) {
+  ScheduledBlockPair scheduled;
+  if ( _unscheduled_blocks.try_pop(scheduled) ) {
+    blocks = scheduled.blocks;
     _quotient_graph[blocks.i][blocks.j].markAsNotInQueue();
   }
   return blocks.i != kInvalidPartition && blocks.j != kInvalidPartition;
@@ -85,7 +88,15 @@ template<typename TypeTraits>
 bool QuotientGraph<TypeTraits>::ActiveBlockSchedulingRound::pushBlockPairIntoQueue(const BlockPair& blocks) {
   QuotientGraphEdge& qg_edge = _quotient_graph[blocks.i][blocks.j];
   if ( qg_edge.markAsInQueue() ) {
-    _unscheduled_blocks.push(blocks);
+    ScheduledBlockPair scheduled { blocks, false, 0.0, _num_pushed_blocks++ };
+    if ( _context.refinement.flows.prioritize_block_pairs ) {
+      // Block pairs are prioritized by the cut weight until we searched them
+      // once. Afterwards, we use the improvement per second of previous searches.
+      scheduled.explored = qg_edge.num_searches.load(std::memory_order_relaxed) > 0;
+      scheduled.priority = scheduled.explored ? qg_edge.expectedImprovementPerSecond() :
+        static_cast<double>(qg_edge.cut_he_weight.load(std::memory_order_relaxed));
+    }
+    _unscheduled_blocks.push(scheduled);
     ++_remaining_blocks;
     return true;
   } else {
@@ -261,6 +272,18 @@ SearchID QuotientGraph<TypeTraits>::requestNewSearch(FlowRefinerAdapter<TypeTrai
   BlockPair blocks { kInvalidPartition, kInvalidPartition };
   size_t round = 0;
   bool success = _active_block_scheduler.popBlockPairFromQueue(blocks, round);
+  const double threshold = _context.refinement.flows.predictor_threshold;
+  while ( success && threshold > 0.0 &&
+          _quotient_graph[blocks.i][blocks.j].predictedSuccessProbability() < threshold ) {
+    // The search on this block pair will most likely not find an improvement
+    const QuotientGraphEdge& qg_edge = _quotient_graph[blocks.i][blocks.j];
+    DBG << "Skip blocks (" << blocks.i << "," << blocks.j << ") ("
+        << "Success Probability =" << qg_edge.predictedSuccessProbability() << ")";
+    ++_num_predicted_skips;
+    _predicted_time_saved_in_us += static_cast<int64_t>(qg_edge.averageRunningTime() * 1000000.0);
+    _active_block_scheduler.finalizeSearch(blocks, round, 0);
+    success = _active_block_scheduler.popBlockPairFromQueue(blocks, round);
+  }
   _register_search_lock.lock();
 
   const SearchID tmp_search_id = _searches.size();
@@ -268,7 +291,17 @@ SearchID QuotientGraph<TypeTraits>::requestNewSearch(FlowRefinerAdapter<TypeTrai
     ++_num_active_searches;
     // Create new search
     search_id = tmp_search_id;
-    _searches.emplace_back(blocks, round);
+    const QuotientGraphEdge& qg_edge = _quotient_graph[blocks.i][blocks.j];
+    SearchFeatures features;
+    features.cut_weight = qg_edge.cut_he_weight.load(std::memory_order_relaxed);
+    features.num_cut_hes = qg_edge.num_cut_hes.load(std::memory_order_relaxed);
+    features.num_searches = qg_edge.num_searches.load(std::memory_order_relaxed);
+    features.num_improvements = qg_edge.num_improvements_found.load(std::memory_order_relaxed);
+    features.total_improvement = qg_edge.total_improvement.load(std::memory_order_relaxed);
+    features.average_running_time = qg_edge.averageRunningTime();
+    features.relative_cut_change = qg_edge.relativeCutChange();
+    features.success_probability = qg_edge.predictedSuccessProbability();
+    _searches.emplace_back(blocks, round, features);
     _register_search_lock.unlock();
 
     // Associate refiner with search id
@@ -283,6 +316,35 @@ SearchID QuotientGraph<TypeTraits>::requestNewSearch(FlowRefinerAdapter<TypeTrai
   return search_id;
 }
 
+template<typename TypeTraits>
+vec<PartitionID> QuotientGraph<TypeTraits>::blocksOfRegion(const SearchID search_id,
+                                                           const size_t max_blocks) const {
+  ASSERT(search_id < _searches.size());
+  const BlockPair& blocks = _searches[search_id].blocks;
+  vec<PartitionID> region_blocks = { blocks.i, blocks.j };
+  if ( max_blocks > 2 ) {
+    // Adjacent blocks are ranked by the heaviest cut to one of the blocks of the search
+    vec<std::pair<HyperedgeWeight, PartitionID>> adjacent_blocks;
+    for ( PartitionID other = 0; other < _context.partition.k; ++other ) {
+      if ( other != blocks.i && other != blocks.j ) {
+        const HyperedgeWeight cut_weight = std::max(
+          getCutHyperedgeWeightOfBlockPair(std::min(blocks.i, other), std::max(blocks.i, other)),
+          getCutHyperedgeWeightOfBlockPair(std::min(blocks.j, other), std::max(blocks.j, other)));
+        if ( cut_weight > 0 ) {
+          adjacent_blocks.emplace_back(cut_weight, other);
+        }
+      }
+    }
+    const size_t num_adjacent_blocks = std::min(max_blocks - 2, adjacent_blocks.size());
+    std::partial_sort(adjacent_blocks.begin(), adjacent_blocks.begin() + num_adjacent_blocks,
+      adjacent_blocks.end(), std::greater<std::pair<HyperedgeWeight, PartitionID>>());
+    for ( size_t i = 0; i < num_adjacent_blocks; ++i ) {
+      region_blocks.push_back(adjacent_blocks[i].second);
+    }
+  }
+  return region_blocks;
+}
+
 template<typename TypeTraits>
 void QuotientGraph<TypeTraits>::addNewCutHyperedge(const HyperedgeID he,
                                                    const PartitionID block) {
@@ -307,13 +369,18 @@ void QuotientGraph<TypeTraits>::finalizeConstruction(const SearchID search_id) {
 
 template<typename TypeTraits>
 void QuotientGraph<TypeTraits>::finalizeSearch(const SearchID search_id,
-                                               const HyperedgeWeight total_improvement) {
+                                               const HyperedgeWeight total_improvement,
+                                               const double running_time) {
   ASSERT(_phg);
   ASSERT(search_id < _searches.size());
   ASSERT(_searches[search_id].is_finalized);
 
   const BlockPair& blocks = _searches[search_id].blocks;
   QuotientGraphEdge& qg_edge = _quotient_graph[blocks.i][blocks.j];
+  ++qg_edge.num_searches;
+  qg_edge.running_time_in_us += static_cast<int64_t>(running_time * 1000000.0);
+  qg_edge.cut_he_weight_at_last_search.store(
+    qg_edge.cut_he_weight.load(std::memory_order_relaxed), std::memory_order_relaxed);
   if ( total_improvement > 0 ) {
     // If the search improves the quality of the partition, we reinsert
     // all hyperedges that were used by the search and are still cut.
@@ -335,6 +402,8 @@ void QuotientGraph<TypeTraits>::initialize(const PartitionedHypergraph& phg) {
   resetQuotientGraphEdges();
   _num_active_searches.store(0, std::memory_order_relaxed);
   _searches.clear();
+  _num_predicted_skips.store(0, std::memory_order_relaxed);
+  _predicted_time_saved_in_us.store(0, std::memory_order_relaxed);
 
   // Find all cut hyperedges between the blocks
   tbb::enumerable_thread_specific<HyperedgeID> local_num_hes(0);
@@ -363,6 +432,9 @@ void QuotientGraph<TypeTraits>::changeNumberOfBlocks(const PartitionID new_k) {
     for ( size_t j = 0; j < _quotient_graph.size(); ++j ) {
       _quotient_graph[i][j].num_improvements_found.store(0, std::memory_order_relaxed);
       _quotient_graph[i][j].total_improvement.store(0, std::memory_order_relaxed);
+      _quotient_graph[i][j].num_searches.store(0, std::memory_order_relaxed);
+      _quotient_graph[i][j].running_time_in_us.store(0, std::memory_order_relaxed);
+      _quotient_graph[i][j].cut_he_weight_at_last_search.store(0, std::memory_order_relaxed);
     }
   }
 
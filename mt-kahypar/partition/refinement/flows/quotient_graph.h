@@ -26,7 +26,7 @@
 
 #pragma once
 
-#include "tbb/concurrent_queue.h"
+#include "tbb/concurrent_priority_queue.h"
 #include "tbb/concurrent_vector.h"
 #include "tbb/enumerable_thread_specific.h"
 
@@ -60,7 +60,11 @@ class QuotientGraph {
       num_cut_hes(0),
       cut_he_weight(0),
       num_improvements_found(0),
-      total_improvement(0) { }
+      total_improvement(0),
+      num_searches(0),
+      running_time_in_us(0),
+      cut_he_weight_at_last_search(0),
+      unsuccessful_region(0) { }
 
     // ! Adds a cut hyperedge to this quotient graph edge
     void add_hyperedge(const HyperedgeID he,
@@ -106,6 +110,46 @@ class QuotientGraph {
       return is_in_queue.compare_exchange_strong(expected, desired);
     }
 
+    // ! Expected improvement per second of a search on this block pair.
+    // ! The cut weight serves as prior for the improvement, whose influence
+    // ! decays with the number of searches.
+    double expectedImprovementPerSecond() const {
+      const double searches = num_searches.load(std::memory_order_relaxed);
+      const double seconds = std::max(static_cast<double>(
+        running_time_in_us.load(std::memory_order_relaxed)), 1.0) / 1000000.0;
+      return ( total_improvement.load(std::memory_order_relaxed) +
+        cut_he_weight.load(std::memory_order_relaxed) / ( searches + 1.0 ) ) / seconds;
+    }
+
+    // ! Average running time of a search on this block pair (in seconds)
+    double averageRunningTime() const {
+      const size_t searches = num_searches.load(std::memory_order_relaxed);
+      return searches > 0 ? running_time_in_us.load(std::memory_order_relaxed) /
+        ( 1000000.0 * searches ) : 0.0;
+    }
+
+    // ! Relative change of the cut weight since the last search on this block pair
+    double relativeCutChange() const {
+      if ( num_searches.load(std::memory_order_relaxed) == 0 ) {
+        return 1.0;
+      }
+      const double cut_weight = cut_he_weight.load(std::memory_order_relaxed);
+      const double last_cut_weight = cut_he_weight_at_last_search.load(std::memory_order_relaxed);
+      return std::abs(cut_weight - last_cut_weight) /
+        std::max(std::max(cut_weight, last_cut_weight), 1.0);
+    }
+
+    // ! Predicted probability that a search on this block pair finds an improvement.
+    // ! The success rate of previous searches decreases with each unsuccessful search,
+    // ! but if other refiners changed the cut since the last search, the block pair
+    // ! becomes promising again.
+    double predictedSuccessProbability() const {
+      const double success_rate =
+        ( num_improvements_found.load(std::memory_order_relaxed) + 1.0 ) /
+        ( num_searches.load(std::memory_order_relaxed) + 1.0 );
+      return std::max(success_rate, relativeCutChange());
+    }
+
     // ! Block pair this quotient graph edge represents
     BlockPair blocks;
     // ! Atomic that contains the search currently constructing
@@ -123,6 +167,38 @@ class QuotientGraph {
     CAtomic<size_t> num_improvements_found;
     // ! Total improvement found on this block pair
     CAtomic<HyperedgeWeight> total_improvement;
+    // ! Number of searches on this block pair
+    CAtomic<size_t> num_searches;
+    // ! Total running time of all searches on this block pair
+    CAtomic<int64_t> running_time_in_us;
+    // ! Cut weight after the last search on this block pair
+    CAtomic<HyperedgeWeight> cut_he_weight_at_last_search;
+    // ! Fingerprint of the region of the last search on this block pair
+    // ! that did not find an improvement (zero, if there is none)
+    CAtomic<uint64_t> unsuccessful_region;
+  };
+
+  // ! Block pair contained in the queue of a round of the active block scheduling strategy
+  struct ScheduledBlockPair {
+    BlockPair blocks;
+    // ! True, if there was already a search on the block pair
+    bool explored;
+    // ! Cut weight (unexplored) or expected improvement per second (explored)
+    double priority;
+    // ! Position in which the block pair was pushed into the queue
+    size_t sequence;
+  };
+
+  // ! Unexplored block pairs are scheduled first. Ties are broken in FIFO order.
+  struct ScheduledBlockPairComparator {
+    bool operator()(const ScheduledBlockPair& lhs, const ScheduledBlockPair& rhs) const {
+      if ( lhs.explored != rhs.explored ) {
+        return lhs.explored;
+      } else if ( lhs.priority != rhs.priority ) {
+        return lhs.priority < rhs.priority;
+      }
+      return lhs.sequence > rhs.sequence;
+    }
   };
 
   /**
@@ -136,6 +212,7 @@ class QuotientGraph {
       _context(context),
       _quotient_graph(quotient_graph),
       _unscheduled_blocks(),
+      _num_pushed_blocks(0),
       _round_improvement(0),
       _active_blocks_lock(),
       _active_blocks(context.partition.k, false),
@@ -174,8 +251,10 @@ class QuotientGraph {
    const Context& _context;
    // ! Quotient graph
     vec<vec<QuotientGraphEdge>>& _quotient_graph;
-    // ! Queue that contains all unscheduled block pairs of the current round
-    tbb::concurrent_queue<BlockPair> _unscheduled_blocks;
+    // ! Queue that contains all unscheduled block pairs of the current round.
+    // ! Without r-flow-prioritize-block-pairs, it behaves like a FIFO queue.
+    tbb::concurrent_priority_queue<ScheduledBlockPair, ScheduledBlockPairComparator> _unscheduled_blocks;
+    CAtomic<size_t> _num_pushed_blocks;
     // ! Current improvement made in this round
     CAtomic<HyperedgeWeight> _round_improvement;
     // Active blocks for next round
@@ -272,17 +351,36 @@ class QuotientGraph {
     bool _is_input_hypergraph;
   };
 
+ public:
+  // ! Cheap features of a block pair that are available before a search starts
+  struct SearchFeatures {
+    HyperedgeWeight cut_weight = 0;
+    size_t num_cut_hes = 0;
+    size_t num_searches = 0;
+    size_t num_improvements = 0;
+    HyperedgeWeight total_improvement = 0;
+    double average_running_time = 0.0;
+    double relative_cut_change = 0.0;
+    double success_probability = 0.0;
+  };
+
+ private:
   // Contains information required by a local search
   struct Search {
-    explicit Search(const BlockPair& blocks, const size_t round) :
+    explicit Search(const BlockPair& blocks,
+                    const size_t round,
+                    const SearchFeatures& features) :
       blocks(blocks),
       round(round),
+      features(features),
       is_finalized(false) { }
 
     // ! Block pair on which this search operates on
     BlockPair blocks;
     // ! Round of active block scheduling
     size_t round;
+    // ! Features of the block pair when the search was started
+    SearchFeatures features;
     // ! Flag indicating if construction of the corresponding search
     // ! is finalized
     bool is_finalized;
@@ -302,7 +400,9 @@ public:
     _register_search_lock(),
     _active_block_scheduler(context, _quotient_graph),
     _num_active_searches(0),
-    _searches() {
+    _searches(),
+    _num_predicted_skips(0),
+    _predicted_time_saved_in_us(0) {
     for ( PartitionID i = 0; i < _context.partition.k; ++i ) {
       for ( PartitionID j = i + 1; j < _context.partition.k; ++j ) {
         _quotient_graph[i][j].blocks.i = i;
@@ -332,11 +432,32 @@ public:
     return _searches[search_id].blocks;
   }
 
+  // ! Features of the block pair of the corresponding search (for r-flow-log-search-features)
+  const SearchFeatures& searchFeatures(const SearchID search_id) const {
+    ASSERT(search_id < _searches.size());
+    return _searches[search_id].features;
+  }
+
+  // ! Number of block pairs that were not searched, because the predicted
+  // ! success probability was below r-flow-predictor-threshold
+  size_t numPredictedSkips() const {
+    return _num_predicted_skips.load(std::memory_order_relaxed);
+  }
+
+  // ! Estimated running time saved by skipping searches (in seconds)
+  double predictedTimeSaved() const {
+    return _predicted_time_saved_in_us.load(std::memory_order_relaxed) / 1000000.0;
+  }
+
   // ! Number of block pairs used by the corresponding search
   size_t numBlockPairs(const SearchID) const {
     return 1;
   }
 
+  // ! Returns the blocks of the corresponding search followed by at most
+  // ! max_blocks - 2 adjacent blocks with the heaviest cut to one of them
+  vec<PartitionID> blocksOfRegion(const SearchID search_id, const size_t max_blocks) const;
+
   template<typename F>
   void doForAllCutHyperedgesOfSearch(const SearchID search_id, const F& f) {
     const BlockPair& blocks = _searches[search_id].blocks;
@@ -376,7 +497,35 @@ public:
    * and are still cut between the corresponding block.
    */
   void finalizeSearch(const SearchID search_id,
-                      const HyperedgeWeight total_improvement);
+                      const HyperedgeWeight total_improvement,
+                      const double running_time = 0.0);
+
+  // ! Returns true, if we never found an improvement on the block pair
+  // ! of the corresponding search, although it was already searched several times
+  bool isHopelessBlockPair(const SearchID search_id) const {
+    ASSERT(search_id < _searches.size());
+    const BlockPair& blocks = _searches[search_id].blocks;
+    const QuotientGraphEdge& qg_edge = _quotient_graph[blocks.i][blocks.j];
+    return qg_edge.num_searches.load(std::memory_order_relaxed) >= 2 &&
+      qg_edge.num_improvements_found.load(std::memory_order_relaxed) == 0;
+  }
+
+  // ! Returns true, if the last search on the block pair of the corresponding
+  // ! search did not find an improvement on a region with the same fingerprint
+  bool isUnsuccessfulRegion(const SearchID search_id, const uint64_t fingerprint) const {
+    ASSERT(search_id < _searches.size());
+    const BlockPair& blocks = _searches[search_id].blocks;
+    return fingerprint != 0 &&
+      _quotient_graph[blocks.i][blocks.j].unsuccessful_region.load(std::memory_order_relaxed) == fingerprint;
+  }
+
+  // ! Stores the fingerprint of the region of a search that did not find an
+  // ! improvement. Passing zero invalidates the stored region.
+  void setUnsuccessfulRegion(const SearchID search_id, const uint64_t fingerprint) {
+    ASSERT(search_id < _searches.size());
+    const BlockPair& blocks = _searches[search_id].blocks;
+    _quotient_graph[blocks.i][blocks.j].unsuccessful_region.store(fingerprint, std::memory_order_relaxed);
+  }
 
   // ! Initializes the quotient graph. This includes to find
   // ! all cut hyperedges between all block pairs
@@ -388,7 +537,7 @@ public:
 
   size_t numActiveBlockPairs() const;
 
-  // ! Only for testing
+  // ! Returns the weight of all cut hyperedges between block i and j
   HyperedgeWeight getCutHyperedgeWeightOfBlockPair(const PartitionID i, const PartitionID j) const {
     ASSERT(i < j);
     ASSERT(0 <= i && i < _context.partition.k);
@@ -423,6 +572,10 @@ public:
   CAtomic<size_t> _num_active_searches;
   // ! Information about searches that are currently running
   tbb::concurrent_vector<Search> _searches;
+
+  // ! Block pairs skipped due to a low predicted success probability
+  CAtomic<size_t> _num_predicted_skips;
+  CAtomic<int64_t> _predicted_time_saved_in_us;
 };
 
 }  // namespace kahypar
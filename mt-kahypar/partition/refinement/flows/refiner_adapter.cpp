@@ -47,7 +47,7 @@ bool FlowRefinerAdapter<TypeTraits>::registerNewSearch(const SearchID search_id,
     // However, this function is not called in increasing search id order.
     _search_lock.lock();
     while ( static_cast<size_t>(search_id) >= _active_searches.size() ) {
-      _active_searches.push_back(ActiveSearch { INVALID_REFINER_IDX, NOW, 0.0, false });
+      _active_searches.push_back(ActiveSearch { INVALID_REFINER_IDX, NOW, NOW, 0.0, false });
     }
     _search_lock.unlock();
 
@@ -58,9 +58,13 @@ bool FlowRefinerAdapter<TypeTraits>::registerNewSearch(const SearchID search_id,
 
     _active_searches[search_id].refiner_idx = refiner_idx;
     _active_searches[search_id].start = NOW;
+    _active_searches[search_id].time_slice_start = _active_searches[search_id].start;
     mt_kahypar_partitioned_hypergraph_const_t partitioned_hg =
       utils::partitioned_hg_const_cast(phg);
     _refiner[refiner_idx]->initialize(partitioned_hg);
+    _search_lock.lock();
+    _time_limit_scaling[refiner_idx] = 1.0;
+    _search_lock.unlock();
     _refiner[refiner_idx]->updateTimeLimit(timeLimit());
   } else {
     success = false;
@@ -81,7 +85,8 @@ MoveSequence FlowRefinerAdapter<TypeTraits>::refine(const SearchID search_id,
   const size_t refiner_idx = _active_searches[search_id].refiner_idx;
   const size_t num_free_threads = _threads.acquireFreeThreads();
   _refiner[refiner_idx]->setNumThreadsForSearch(num_free_threads);
-  MoveSequence moves = _refiner[refiner_idx]->refine(partitioned_hg, sub_hg, _active_searches[search_id].start);
+  MoveSequence moves = _refiner[refiner_idx]->refine(
+    partitioned_hg, sub_hg, _active_searches[search_id].time_slice_start);
   _threads.releaseThreads(num_free_threads);
   _active_searches[search_id].reaches_time_limit = moves.state == MoveSequenceState::TIME_LIMIT;
   return moves;
@@ -112,11 +117,13 @@ void FlowRefinerAdapter<TypeTraits>::finalizeSearch(const SearchID search_id) {
 
   // Search position of refiner associated with the search id
   if ( shouldSetTimeLimit() ) {
+    _search_lock.lock();
     for ( size_t idx = 0; idx < _refiner.size(); ++idx ) {
       if ( _refiner[idx] ) {
-        _refiner[idx]->updateTimeLimit(timeLimit());
+        _refiner[idx]->updateTimeLimit(timeLimit() * _time_limit_scaling[idx]);
       }
     }
+    _search_lock.unlock();
   }
 
   ASSERT(_active_searches[search_id].refiner_idx != INVALID_REFINER_IDX);
@@ -124,6 +131,25 @@ void FlowRefinerAdapter<TypeTraits>::finalizeSearch(const SearchID search_id) {
   _active_searches[search_id].refiner_idx = INVALID_REFINER_IDX;
 }
 
+template<typename TypeTraits>
+void FlowRefinerAdapter<TypeTraits>::startTimeSlice(const SearchID search_id) {
+  ASSERT(static_cast<size_t>(search_id) < _active_searches.size());
+  ASSERT(_active_searches[search_id].refiner_idx != INVALID_REFINER_IDX);
+  _active_searches[search_id].time_slice_start = NOW;
+}
+
+template<typename TypeTraits>
+void FlowRefinerAdapter<TypeTraits>::setTimeLimitScaling(const SearchID search_id,
+                                                         const double scaling) {
+  ASSERT(static_cast<size_t>(search_id) < _active_searches.size());
+  ASSERT(_active_searches[search_id].refiner_idx != INVALID_REFINER_IDX);
+  const size_t refiner_idx = _active_searches[search_id].refiner_idx;
+  _search_lock.lock();
+  _time_limit_scaling[refiner_idx] = scaling;
+  _search_lock.unlock();
+  _refiner[refiner_idx]->updateTimeLimit(timeLimit() * scaling);
+}
+
 template<typename TypeTraits>
 void FlowRefinerAdapter<TypeTraits>::initialize(const size_t max_parallelism) {
   _num_parallel_refiners = max_parallelism;
@@ -47,6 +47,8 @@ class FlowRefinerAdapter {
   struct ActiveSearch {
     size_t refiner_idx;
     HighResClockTimepoint start;
+    // ! Start of the current time slice of the search
+    HighResClockTimepoint time_slice_start;
     double running_time;
     bool reaches_time_limit;
   };
@@ -102,6 +104,7 @@ public:
     _context(context),
     _unused_refiners(),
     _refiner(),
+    _time_limit_scaling(),
     _search_lock(),
     _active_searches(),
     _threads(),
@@ -110,6 +113,7 @@ public:
     _average_running_time(0.0) {
     for ( size_t i = 0; i < _context.shared_memory.num_threads; ++i ) {
       _refiner.emplace_back(nullptr);
+      _time_limit_scaling.push_back(1.0);
     }
   }
 
@@ -139,6 +143,14 @@ public:
   // ! available again
   void finalizeSearch(const SearchID search_id);
 
+  // ! Starts a new time slice for the corresponding search. The time limit
+  // ! of the refiner applies to each time slice of a search.
+  void startTimeSlice(const SearchID search_id);
+
+  // ! Scales the time limit of the refiner associated with the
+  // ! corresponding search id (until the search terminates)
+  void setTimeLimitScaling(const SearchID search_id, const double scaling);
+
   void terminateRefiner() {
     _threads.terminateRefiner();
   }
@@ -178,6 +190,8 @@ private:
   tbb::concurrent_queue<size_t> _unused_refiners;
   // ! Available refiners
   vec<std::unique_ptr<IFlowRefiner>> _refiner;
+  // ! Scaling factor of the time limit of each refiner (protected by _search_lock)
+  vec<double> _time_limit_scaling;
   // ! Mapping from search id to refiner
   SpinLock _search_lock;
   tbb::concurrent_vector<ActiveSearch> _active_searches;
@@ -36,13 +36,23 @@
 namespace mt_kahypar {
 
 template<typename GraphAndGainTypes>
-void FlowRefinementScheduler<GraphAndGainTypes>::RefinementStats::update_global_stats() {
+void FlowRefinementScheduler<GraphAndGainTypes>::RefinementStats::update_global_stats(const bool with_block_pair_stats) {
   _stats.update_stat("num_flow_refinements",
     num_refinements.load(std::memory_order_relaxed));
   _stats.update_stat("num_flow_improvement",
     num_improvements.load(std::memory_order_relaxed));
   _stats.update_stat("num_time_limits",
     num_time_limits.load(std::memory_order_relaxed));
+  _stats.update_stat("num_skipped_unchanged_flow_regions",
+    num_skipped_unchanged_regions.load(std::memory_order_relaxed));
+  _stats.update_stat("num_hopeless_flow_searches",
+    num_hopeless_searches.load(std::memory_order_relaxed));
+  _stats.update_stat("num_multiway_flow_problems",
+    num_multiway_flow_problems.load(std::memory_order_relaxed));
+  _stats.update_stat("num_preempted_flow_searches",
+    num_preempted_searches.load(std::memory_order_relaxed));
+  _stats.update_stat("num_predicted_flow_search_skips", num_predicted_skips);
+  _stats.update_stat("predicted_flow_search_time_saved", predicted_time_saved);
   _stats.update_stat("correct_expected_improvement",
     correct_expected_improvement.load(std::memory_order_relaxed));
   _stats.update_stat("zero_gain_improvement",
@@ -55,6 +65,22 @@ void FlowRefinementScheduler<GraphAndGainTypes>::RefinementStats::update_global_
     failed_updates_due_to_balance_constraint.load(std::memory_order_relaxed));
   _stats.update_stat("total_flow_refinement_improvement",
     total_improvement.load(std::memory_order_relaxed));
+  if ( with_block_pair_stats ) {
+    for ( PartitionID i = 0; i < _k; ++i ) {
+      for ( PartitionID j = i + 1; j < _k; ++j ) {
+        const BlockPairStats& pair = block_pairs[i * _k + j];
+        if ( pair.num_searches.load(std::memory_order_relaxed) > 0 ) {
+          const std::string prefix = "flow_block_pair_" + std::to_string(i) + "_" + std::to_string(j);
+          _stats.update_stat(prefix + "_searches",
+            pair.num_searches.load(std::memory_order_relaxed));
+          _stats.update_stat(prefix + "_running_time",
+            pair.running_time_in_us.load(std::memory_order_relaxed) / 1000000.0);
+          _stats.update_stat(prefix + "_improvement",
+            pair.improvement.load(std::memory_order_relaxed));
+        }
+      }
+    }
+  }
 }
 
 template<typename GraphAndGainTypes>
@@ -78,32 +104,88 @@ bool FlowRefinementScheduler<GraphAndGainTypes>::refineImpl(
         DBG << "Start search" << search_id
             << "( Blocks =" << blocksOfSearch(search_id)
             << ", Refiner =" << i << ")";
-        timer.start_timer("region_growing", "Grow Region", true);
-        const Subhypergraph sub_hg =
-          _constructor.construct(search_id, _quotient_graph, phg);
-        _quotient_graph.finalizeConstruction(search_id);
-        timer.stop_timer("region_growing");
-
+        if ( _context.refinement.flows.prioritize_block_pairs &&
+             _context.refinement.flows.time_limit_factor > 1.0 &&
+             _quotient_graph.isHopelessBlockPair(search_id) ) {
+          // Searches on block pairs that never led to an improvement are
+          // terminated once they exceed the average running time
+          _refiner.setTimeLimitScaling(search_id, 1.0 / _context.refinement.flows.time_limit_factor);
+          ++_stats.num_hopeless_searches;
+        }
         HyperedgeWeight delta = 0;
         bool improved_solution = false;
-        if ( sub_hg.numNodes() > 0 ) {
-          ++_stats.num_refinements;
-          MoveSequence sequence = _refiner.refine(search_id, phg, sub_hg);
-
-          if ( !sequence.moves.empty() ) {
-            timer.start_timer("apply_moves", "Apply Moves", true);
-            delta = applyMoves(search_id, sequence);
-            overall_delta -= delta;
-            improved_solution = sequence.state == MoveSequenceState::SUCCESS && delta > 0;
-            timer.stop_timer("apply_moves");
-          } else if ( sequence.state == MoveSequenceState::TIME_LIMIT ) {
-            ++_stats.num_time_limits;
-            DBG << RED << "Search" << search_id << "reaches the time limit ( Time Limit ="
-                << _refiner.timeLimit() << "s )" << END;
+        size_t region_nodes = 0;
+        size_t region_pins = 0;
+        if ( _context.refinement.flows.max_blocks_per_region > 2 ) {
+          timer.start_timer("region_growing", "Grow Region", true);
+          const MultiwayRegion region =
+            _constructor.constructMultiwayRegion(search_id, _quotient_graph, phg);
+          _quotient_graph.finalizeConstruction(search_id);
+          timer.stop_timer("region_growing");
+          region_nodes = region.numNodes();
+          region_pins = region.num_pins;
+
+          // We solve a flow problem on each block pair of the region that is connected
+          // via cut hyperedges, starting with the block pair of the search. All flow
+          // problems share the region and each of them sees the moves of the previous ones.
+          bool time_limit_reached = false;
+          for ( size_t a = 0; a < region.blocks.size() && !time_limit_reached; ++a ) {
+            for ( size_t b = a + 1; b < region.blocks.size() && !time_limit_reached; ++b ) {
+              const bool is_search_block_pair = a == 0 && b == 1;
+              const PartitionID block_0 = std::min(region.blocks[a], region.blocks[b]);
+              const PartitionID block_1 = std::max(region.blocks[a], region.blocks[b]);
+              if ( !is_search_block_pair &&
+                   _quotient_graph.getCutHyperedgeWeightOfBlockPair(block_0, block_1) == 0 ) {
+                continue;
+              }
+
+              timer.start_timer("extract_block_pair", "Extract Block Pair", true);
+              const Subhypergraph sub_hg =
+                _constructor.extractBlockPair(phg, region, block_0, block_1);
+              timer.stop_timer("extract_block_pair");
+              if ( !is_search_block_pair && sub_hg.numNodes() > 0 ) {
+                ++_stats.num_multiway_flow_problems;
+              }
+
+              HyperedgeWeight pair_delta = 0;
+              const MoveSequenceState state = refineSubhypergraph(search_id, phg, sub_hg, pair_delta);
+              overall_delta -= pair_delta;
+              if ( state == MoveSequenceState::SUCCESS && pair_delta > 0 ) {
+                delta += pair_delta;
+                improved_solution = true;
+              }
+              time_limit_reached = state == MoveSequenceState::TIME_LIMIT;
+            }
+          }
+
+          if ( _context.refinement.flows.disjoint_regions ) {
+            _constructor.releaseNodes(search_id, region);
+          }
+        } else {
+          timer.start_timer("region_growing", "Grow Region", true);
+          const Subhypergraph sub_hg =
+            _constructor.construct(search_id, _quotient_graph, phg);
+          _quotient_graph.finalizeConstruction(search_id);
+          timer.stop_timer("region_growing");
+          region_nodes = sub_hg.numNodes();
+          region_pins = sub_hg.num_pins;
+
+          const MoveSequenceState state = refineSubhypergraph(search_id, phg, sub_hg, delta);
+          overall_delta -= delta;
+          improved_solution = state == MoveSequenceState::SUCCESS && delta > 0;
+
+          if ( _context.refinement.flows.disjoint_regions ) {
+            _constructor.releaseNodes(search_id, sub_hg);
           }
         }
-        _quotient_graph.finalizeSearch(search_id, improved_solution ? delta : 0);
         _refiner.finalizeSearch(search_id);
+        const BlockPair blocks = _quotient_graph.getBlockPair(search_id);
+        const HyperedgeWeight improvement = improved_solution ? delta : 0;
+        _stats.update_block_pair_stats(blocks.i, blocks.j, _refiner.runningTime(search_id), improvement);
+        if ( _context.refinement.flows.log_search_features ) {
+          logSearchFeatures(search_id, region_nodes, region_pins, improvement);
+        }
+        _quotient_graph.finalizeSearch(search_id, improvement, _refiner.runningTime(search_id));
         DBG << "End search" << search_id
             << "( Blocks =" << blocksOfSearch(search_id)
             << ", Refiner =" << i
@@ -133,7 +215,9 @@ bool FlowRefinementScheduler<GraphAndGainTypes>::refineImpl(
     V(best_metrics.quality) << V(overall_delta) << V(metrics::quality(phg, _context)));
   best_metrics.quality += overall_delta;
   best_metrics.imbalance = metrics::imbalance(phg, _context);
-  _stats.update_global_stats();
+  _stats.num_predicted_skips = _quotient_graph.numPredictedSkips();
+  _stats.predicted_time_saved = _quotient_graph.predictedTimeSaved();
+  _stats.update_global_stats(_context.refinement.flows.prioritize_block_pairs);
 
   // Update Gain Cache
   if ( _context.forceGainCacheUpdates() && _gain_cache.isInitialized() ) {
@@ -145,11 +229,81 @@ bool FlowRefinementScheduler<GraphAndGainTypes>::refineImpl(
     });
   }
 
+  if ( _context.partition.show_memory_consumption && _context.partition.verbose_output &&
+       _context.type == ContextType::main &&
+       phg.initialNumNodes() == _was_moved.size() /* top level */ ) {
+    printMemoryConsumption();
+  }
+
   HEAVY_REFINEMENT_ASSERT(phg.checkTrackedPartitionInformation(_gain_cache));
   _phg = nullptr;
   return overall_delta.load(std::memory_order_relaxed) < 0;
 }
 
+template<typename GraphAndGainTypes>
+MoveSequenceState FlowRefinementScheduler<GraphAndGainTypes>::refineSubhypergraph(const SearchID search_id,
+                                                                                  PartitionedHypergraph& phg,
+                                                                                  const Subhypergraph& sub_hg,
+                                                                                  HyperedgeWeight& delta) {
+  delta = 0;
+  MoveSequenceState state = MoveSequenceState::IN_PROGRESS;
+  // Only the block pair of the search stores the fingerprint of its last unsuccessful region
+  const BlockPair blocks = _quotient_graph.getBlockPair(search_id);
+  const bool check_unchanged_region = _context.refinement.flows.skip_unchanged_regions &&
+    sub_hg.block_0 == blocks.i && sub_hg.block_1 == blocks.j;
+  if ( sub_hg.numNodes() > 0 && check_unchanged_region &&
+       _quotient_graph.isUnsuccessfulRegion(search_id, sub_hg.fingerprint) ) {
+    // The last search on this block pair already solved the same flow problem
+    // without finding an improvement
+    ++_stats.num_skipped_unchanged_regions;
+  } else if ( sub_hg.numNodes() > 0 ) {
+    utils::Timer& timer = utils::Utilities::instance().getTimer(_context.utility_id);
+    ++_stats.num_refinements;
+    MoveSequence sequence = _refiner.refine(search_id, phg, sub_hg);
+
+    // A search that reaches the time limit yields back to the scheduler. We restart
+    // it in a new time slice on the half of its region that is closest to the cut.
+    Subhypergraph shrunk_hg;
+    size_t num_time_slices = 1;
+    while ( sequence.state == MoveSequenceState::TIME_LIMIT &&
+            num_time_slices < _context.refinement.flows.max_time_slices ) {
+      const Subhypergraph& current_hg = num_time_slices == 1 ? sub_hg : shrunk_hg;
+      Subhypergraph next_hg = _constructor.shrinkRegion(phg, current_hg, 0.5);
+      if ( next_hg.numNodes() == current_hg.numNodes() ) {
+        break;
+      }
+      shrunk_hg = std::move(next_hg);
+      ++num_time_slices;
+      ++_stats.num_preempted_searches;
+      DBG << "Search" << search_id << "is preempted and restarts on region" << shrunk_hg;
+      _refiner.startTimeSlice(search_id);
+      sequence = _refiner.refine(search_id, phg, shrunk_hg);
+    }
+
+    if ( !sequence.moves.empty() ) {
+      timer.start_timer("apply_moves", "Apply Moves", true);
+      delta = applyMoves(search_id, sequence);
+      timer.stop_timer("apply_moves");
+    } else if ( sequence.state == MoveSequenceState::TIME_LIMIT ) {
+      ++_stats.num_time_limits;
+      DBG << RED << "Search" << search_id << "reaches the time limit ( Time Limit ="
+          << _refiner.timeLimit() << "s )" << END;
+    }
+    state = sequence.state;
+
+    if ( check_unchanged_region ) {
+      // Searches that reached the time limit might succeed in a later round
+      // (this also holds if only a part of the region was searched)
+      const bool improved_solution = state == MoveSequenceState::SUCCESS && delta > 0;
+      const bool searched_whole_region = num_time_slices == 1;
+      _quotient_graph.setUnsuccessfulRegion(search_id,
+        improved_solution || state == MoveSequenceState::TIME_LIMIT || !searched_whole_region ?
+          0 : sub_hg.fingerprint);
+    }
+  }
+  return state;
+}
+
 template<typename GraphAndGainTypes>
 void FlowRefinementScheduler<GraphAndGainTypes>::initializeImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph)  {
   PartitionedHypergraph& phg = utils::cast<PartitionedHypergraph>(hypergraph);
@@ -175,6 +329,44 @@ void FlowRefinementScheduler<GraphAndGainTypes>::initializeImpl(mt_kahypar_parti
   _refiner.initialize(max_parallism);
 }
 
+template<typename GraphAndGainTypes>
+void FlowRefinementScheduler<GraphAndGainTypes>::logSearchFeatures(const SearchID search_id,
+                                                                  const size_t region_nodes,
+                                                                  const size_t region_pins,
+                                                                  const HyperedgeWeight improvement) {
+  const BlockPair blocks = _quotient_graph.getBlockPair(search_id);
+  const auto& features = _quotient_graph.searchFeatures(search_id);
+  std::stringstream oss;
+  oss << "FLOW_SEARCH"
+      << " k=" << _context.partition.k
+      << " num_nodes=" << _phg->initialNumNodes()
+      << " block_0=" << blocks.i
+      << " block_1=" << blocks.j
+      << " cut_weight=" << features.cut_weight
+      << " num_cut_hes=" << features.num_cut_hes
+      << " num_searches=" << features.num_searches
+      << " num_improvements=" << features.num_improvements
+      << " total_improvement=" << features.total_improvement
+      << " average_running_time=" << features.average_running_time
+      << " relative_cut_change=" << features.relative_cut_change
+      << " success_probability=" << features.success_probability
+      << " region_nodes=" << region_nodes
+      << " region_pins=" << region_pins
+      << " improvement=" << improvement
+      << " running_time=" << _refiner.runningTime(search_id);
+  LOG << oss.str();
+}
+
+template<typename GraphAndGainTypes>
+void FlowRefinementScheduler<GraphAndGainTypes>::printMemoryConsumption() {
+  utils::MemoryTreeNode flow_memory("Flow Refinement Scheduler", utils::OutputType::MEGABYTE);
+  _constructor.memoryConsumption(&flow_memory);
+  flow_memory.finalize();
+
+  LOG << BOLD << "\n Flow Memory Consumption" << END;
+  LOG << flow_memory;
+}
+
 template<typename GraphAndGainTypes>
 void FlowRefinementScheduler<GraphAndGainTypes>::resizeDataStructuresForCurrentK() {
   if ( _current_k != _context.partition.k ) {
@@ -274,9 +466,14 @@ HyperedgeWeight FlowRefinementScheduler<GraphAndGainTypes>::applyMoves(const Sea
   unused(search_id);
   ASSERT(_phg);
 
-  // TODO: currently we lock the applyMoves method
-  // => find something smarter here
-  _apply_moves_lock.lock();
+  // If the regions of all searches are disjoint, no other search can move the nodes
+  // of the move sequence. The attributed gains of concurrent moves are exact and the
+  // part weights are updated as a transaction. Hence, we only need to lock
+  // the applyMoves method if regions can overlap.
+  const bool lock_apply_moves = !_context.refinement.flows.disjoint_regions;
+  if ( lock_apply_moves ) {
+    _apply_moves_lock.lock();
+  }
 
   // Compute Part Weight Deltas
   vec<HypernodeWeight> part_weight_deltas(_context.partition.k, 0);
@@ -349,7 +546,9 @@ HyperedgeWeight FlowRefinementScheduler<GraphAndGainTypes>::applyMoves(const Sea
         << ", Search ID =" << search_id << ")" << END;
   }
 
-  _apply_moves_lock.unlock();
+  if ( lock_apply_moves ) {
+    _apply_moves_lock.unlock();
+  }
 
   if ( sequence.state == MoveSequenceState::SUCCESS && improvement > 0 ) {
     addCutHyperedgesToQuotientGraph(_quotient_graph, new_cut_hes);
@@ -65,43 +65,93 @@ class FlowRefinementScheduler final : public IRefiner {
   using GainCache = typename GraphAndGainTypes::GainCache;
   using AttributedGains = typename GraphAndGainTypes::AttributedGains;
 
+  struct BlockPairStats {
+    CAtomic<int64_t> num_searches;
+    CAtomic<int64_t> running_time_in_us;
+    CAtomic<int64_t> improvement;
+  };
+
   struct RefinementStats {
-    RefinementStats(utils::Stats& stats) :
+    RefinementStats(utils::Stats& stats, const PartitionID k) :
       _stats(stats),
+      _k(k),
       num_refinements(0),
       num_improvements(0),
       num_time_limits(0),
+      num_skipped_unchanged_regions(0),
+      num_hopeless_searches(0),
+      num_multiway_flow_problems(0),
+      num_preempted_searches(0),
+      num_predicted_skips(0),
+      predicted_time_saved(0.0),
       correct_expected_improvement(0),
       zero_gain_improvement(0),
       failed_updates_due_to_conflicting_moves(0),
       failed_updates_due_to_conflicting_moves_without_rollback(0),
       failed_updates_due_to_balance_constraint(0),
-      total_improvement(0) { }
+      total_improvement(0),
+      block_pairs(k * k) { }
 
     void reset() {
       num_refinements.store(0);
       num_improvements.store(0);
       num_time_limits.store(0);
+      num_skipped_unchanged_regions.store(0);
+      num_hopeless_searches.store(0);
+      num_multiway_flow_problems.store(0);
+      num_preempted_searches.store(0);
+      num_predicted_skips = 0;
+      predicted_time_saved = 0.0;
       correct_expected_improvement.store(0);
       zero_gain_improvement.store(0);
       failed_updates_due_to_conflicting_moves.store(0);
       failed_updates_due_to_conflicting_moves_without_rollback.store(0);
       failed_updates_due_to_balance_constraint.store(0);
       total_improvement.store(0);
+      for ( BlockPairStats& pair : block_pairs ) {
+        pair.num_searches.store(0);
+        pair.running_time_in_us.store(0);
+        pair.improvement.store(0);
+      }
+    }
+
+    void update_block_pair_stats(const PartitionID i,
+                                 const PartitionID j,
+                                 const double running_time,
+                                 const HyperedgeWeight improvement) {
+      if ( i < _k && j < _k ) {
+        BlockPairStats& pair = block_pairs[i * _k + j];
+        ++pair.num_searches;
+        pair.running_time_in_us += static_cast<int64_t>(running_time * 1000000.0);
+        pair.improvement += improvement;
+      }
     }
 
-    void update_global_stats();
+    void update_global_stats(const bool with_block_pair_stats);
 
     utils::Stats& _stats;
+    const PartitionID _k;
     CAtomic<int64_t> num_refinements;
     CAtomic<int64_t> num_improvements;
     CAtomic<int64_t> num_time_limits;
+    CAtomic<int64_t> num_skipped_unchanged_regions;
+    CAtomic<int64_t> num_hopeless_searches;
+    // ! Flow problems solved on a shared multiway region in addition
+    // ! to the one of the block pair of the search
+    CAtomic<int64_t> num_multiway_flow_problems;
+    // ! Number of restarts of searches that reached the time limit
+    CAtomic<int64_t> num_preempted_searches;
+    // ! Searches skipped by the predictor and their estimated running time
+    int64_t num_predicted_skips;
+    double predicted_time_saved;
     CAtomic<int64_t> correct_expected_improvement;
     CAtomic<int64_t> zero_gain_improvement;
     CAtomic<int64_t> failed_updates_due_to_conflicting_moves;
     CAtomic<int64_t> failed_updates_due_to_conflicting_moves_without_rollback;
     CAtomic<int64_t> failed_updates_due_to_balance_constraint;
     CAtomic<HyperedgeWeight> total_improvement;
+    // ! Number of searches, running time and improvement of each block pair
+    vec<BlockPairStats> block_pairs;
   };
 
   struct PartWeightUpdateResult {
@@ -138,6 +188,9 @@ class FlowRefinementScheduler final : public IRefiner {
     str << "+ Time Limits                       = "
         << progress_bar(stats.num_time_limits, stats.num_refinements,
             [&](const double percentage) { return percentage < 0.0025 ? GREEN : percentage < 0.01 ? YELLOW : RED; }) << "\n";
+    str << "+ Preempted Searches                = "
+        << progress_bar(stats.num_preempted_searches, stats.num_refinements,
+            [&](const double) { return WHITE; }) << "\n";
     str << "---------------------------------------------------------------";
     return str;
   }
@@ -158,7 +211,7 @@ public:
     _part_weights_lock(),
     _part_weights(context.partition.k, 0),
     _max_part_weights(context.partition.k, 0),
-    _stats(utils::Utilities::instance().getStats(context.utility_id)),
+    _stats(utils::Utilities::instance().getStats(context.utility_id), context.partition.k),
     _apply_moves_lock() { }
 
   FlowRefinementScheduler(const HypernodeID num_hypernodes,
@@ -207,9 +260,24 @@ private:
 
   void resizeDataStructuresForCurrentK();
 
+  void printMemoryConsumption();
+
+  // ! Solves the flow problem on the given subhypergraph and applies the resulting
+  // ! moves. Stores the change of the objective function in delta.
+  MoveSequenceState refineSubhypergraph(const SearchID search_id,
+                                        PartitionedHypergraph& phg,
+                                        const Subhypergraph& sub_hg,
+                                        HyperedgeWeight& delta);
+
   PartWeightUpdateResult partWeightUpdate(const vec<HypernodeWeight>& part_weight_deltas,
                                           const bool rollback);
 
+  // ! Prints the features and the outcome of a search (see r-flow-log-search-features)
+  void logSearchFeatures(const SearchID search_id,
+                         const size_t region_nodes,
+                         const size_t region_pins,
+                         const HyperedgeWeight improvement);
+
   std::string blocksOfSearch(const SearchID search_id) {
     const BlockPair blocks = _quotient_graph.getBlockPair(search_id);
     return "(" + std::to_string(blocks.i) + "," + std::to_string(blocks.j) + ")";
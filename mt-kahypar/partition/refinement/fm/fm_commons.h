@@ -28,6 +28,7 @@
 
 #include <limits>
 
+#include <mt-kahypar/datastructures/chunked_vector.h>
 #include <mt-kahypar/datastructures/concurrent_bucket_map.h>
 #include <mt-kahypar/datastructures/priority_queue.h>
 #include <mt-kahypar/partition/context.h>
@@ -42,7 +43,9 @@ namespace mt_kahypar {
 
 
 struct GlobalMoveTracker {
-  vec<Move> moveOrder;
+  // ! The move sequence of the current round. Its logical size is the number of nodes,
+  // ! but memory is only allocated for the chunks that are actually used by a round.
+  ds::ChunkedVector<Move> moveOrder;
   vec<MoveID> moveOfNode;
   CAtomic<MoveID> runningMoveID;
   MoveID firstMoveID = 1;
@@ -68,8 +71,9 @@ struct GlobalMoveTracker {
   MoveID insertMove(const Move &m) {
     const MoveID move_id = runningMoveID.fetch_add(1, std::memory_order_relaxed);
     assert(move_id - firstMoveID < moveOrder.size());
-    moveOrder[move_id - firstMoveID] = m;
-    moveOfNode[m.node] = move_id;
+    moveOrder.set(move_id - firstMoveID, m);
+    // publishes the move (and its chunk) to threads reading moveOfNode concurrently
+    __atomic_store_n(&moveOfNode[m.node], move_id, __ATOMIC_RELEASE);
     return move_id;
   }
 
@@ -79,7 +83,7 @@ struct GlobalMoveTracker {
   }
 
   bool wasNodeMovedInThisRound(HypernodeID u) const {
-    const MoveID m_id = moveOfNode[u];
+    const MoveID m_id = __atomic_load_n(&moveOfNode[u], __ATOMIC_ACQUIRE);
     if (m_id >= firstMoveID && m_id < runningMoveID.load(std::memory_order_relaxed)) {   // active move ID
       ASSERT(moveOrder[m_id - firstMoveID].node == u);
       return moveOrder[m_id - firstMoveID].isValid();  // not reverted already
@@ -279,6 +283,9 @@ struct FMSharedData {
 
   bool release_nodes = true;
 
+  // ! Scales the length of the localized searches (see StopRule)
+  double stopRuleAlpha = 1.0;
+
   FMSharedData(size_t numNodes, size_t numThreads) :
     numberOfNodes(numNodes),
     refinementNodes(), //numNodes, numThreads),
@@ -320,7 +327,7 @@ struct FMSharedData {
     utils::MemoryTreeNode* pq_handles_node = shared_fm_data_node->addChild("PQ Handles");
     pq_handles_node->updateSize(vertexPQHandles.capacity() * sizeof(PosT));
     utils::MemoryTreeNode* move_tracker_node = shared_fm_data_node->addChild("Move Tracker");
-    move_tracker_node->updateSize(moveTracker.moveOrder.capacity() * sizeof(Move) +
+    move_tracker_node->updateSize(moveTracker.moveOrder.size_in_bytes() +
                                   moveTracker.moveOfNode.capacity() * sizeof(MoveID));
     utils::MemoryTreeNode* node_tracker_node = shared_fm_data_node->addChild("Node Tracker");
     node_tracker_node->updateSize(nodeTracker.searchOfNode.capacity() * sizeof(SearchID));
@@ -0,0 +1,147 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "mt-kahypar/partition/context.h"
+#include "mt-kahypar/utils/utilities.h"
+
+namespace mt_kahypar {
+
+/**
+ * Adapts the effort of the multitry FM refiner to the improvement it achieves per second.
+ * The controller measures the relative improvement of each FM round per second and pin
+ * (i.e., the running time is normalized by the size of the level, since rounds on finer levels
+ * naturally take longer) and compares it to the overall rate of all previous rounds (reference rate).
+ *  - A round whose rate drops below a fraction of the reference rate ends the current level.
+ *  - The rate of the previous level determines the effort of the next level, which scales the
+ *    number of rounds, the number of seed nodes and the length of the localized searches.
+ */
+class FMEffortController {
+  static constexpr bool debug = false;
+
+ public:
+  explicit FMEffortController(const Context& context) :
+    _context(context),
+    _effort(1.0),
+    _total_relative_improvement(0.0),
+    _total_normalized_seconds(0.0),
+    _level_relative_improvement(0.0),
+    _level_seconds(0.0),
+    _level_normalized_seconds(0.0),
+    _level_num_pins(1.0),
+    _last_level_rate(-1.0) { }
+
+  // ! Computes the effort for the next level based on the rate of the previous level
+  void startLevel(const size_t num_pins) {
+    _level_num_pins = std::max(static_cast<double>(num_pins), 1.0);
+    _effort = 1.0;
+    const double reference = referenceRate();
+    if ( _last_level_rate >= 0.0 && reference > 0.0 ) {
+      _effort = std::clamp(_last_level_rate / reference,
+        _context.refinement.fm.adaptive_effort_min_effort, 1.0);
+    }
+    _level_relative_improvement = 0.0;
+    _level_seconds = 0.0;
+    _level_normalized_seconds = 0.0;
+  }
+
+  size_t maxRounds() const {
+    const double rounds = std::ceil(_effort * _context.refinement.fm.multitry_rounds);
+    return std::max(static_cast<size_t>(rounds), UL(1));
+  }
+
+  size_t numSeedNodes(const size_t num_seeds) const {
+    const double seeds = std::round(_effort * num_seeds);
+    return std::max(static_cast<size_t>(seeds), UL(1));
+  }
+
+  // ! Scaling factor of the stop rule of the localized searches.
+  // ! An effort of 1 corresponds to the default stop rule.
+  double stopRuleAlpha() const {
+    return 0.5 + 0.5 * _effort;
+  }
+
+  double effort() const {
+    return _effort;
+  }
+
+  // ! Reports the improvement of a round and returns whether or not
+  // ! a further round is expected to be worth its running time
+  bool reportRound(const Gain improvement,
+                   const HyperedgeWeight quality_before_round,
+                   const double seconds) {
+    const double relative_improvement = quality_before_round > 0 ?
+      static_cast<double>(improvement) / static_cast<double>(quality_before_round) : 0.0;
+    const double reference = referenceRate();
+    const double normalized_seconds = std::max(seconds, kMinSeconds) / _level_num_pins;
+    const double rate = relative_improvement / normalized_seconds;
+    _level_relative_improvement += relative_improvement;
+    _level_seconds += seconds;
+    _level_normalized_seconds += normalized_seconds;
+    _total_relative_improvement += relative_improvement;
+    _total_normalized_seconds += normalized_seconds;
+    DBG << V(improvement) << V(seconds) << V(rate) << V(reference) << V(_effort);
+    return reference <= 0.0 || rate >= _context.refinement.fm.adaptive_effort_min_rate_fraction * reference;
+  }
+
+  // ! Stores the rate of the current level and reports statistics
+  void finishLevel(const size_t num_rounds, const bool stopped_early) {
+    _last_level_rate = _level_normalized_seconds > 0.0 ?
+      _level_relative_improvement / _level_normalized_seconds : 0.0;
+    utils::Stats& stats = utils::Utilities::instance().getStats(_context.utility_id);
+    stats.update_stat("fm-effort-levels", 1);
+    stats.update_stat("fm-effort-rounds", static_cast<int64_t>(num_rounds));
+    stats.update_stat("fm-effort-seconds", _level_seconds);
+    if ( stopped_early ) {
+      stats.update_stat("fm-effort-early-stops", 1);
+    }
+    if ( _effort < 1.0 ) {
+      stats.update_stat("fm-effort-reduced-levels", 1);
+    }
+  }
+
+ private:
+  static constexpr double kMinSeconds = 1e-6;
+
+  double referenceRate() const {
+    return _total_normalized_seconds > 0.0 ? _total_relative_improvement / _total_normalized_seconds : 0.0;
+  }
+
+  const Context& _context;
+  double _effort;
+  double _total_relative_improvement;
+  double _total_normalized_seconds;
+  double _level_relative_improvement;
+  double _level_seconds;
+  double _level_normalized_seconds;
+  double _level_num_pins;
+  double _last_level_rate;
+};
+
+}  // namespace mt_kahypar
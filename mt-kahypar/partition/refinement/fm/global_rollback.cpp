@@ -26,12 +26,14 @@
 
 #include "mt-kahypar/partition/refinement/fm/global_rollback.h"
 
+#include "tbb/parallel_reduce.h"
 #include "tbb/parallel_scan.h"
 
 #include "mt-kahypar/definitions.h"
 #include "mt-kahypar/partition/metrics.h"
 #include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
 #include "mt-kahypar/utils/timer.h"
+#include "mt-kahypar/utils/utilities.h"
 #include "mt-kahypar/partition/refinement/gains/gain_cache_ptr.h"
 #include "mt-kahypar/datastructures/bitset.h"
 #include "mt-kahypar/datastructures/pin_count_snapshot.h"
@@ -41,7 +43,7 @@ namespace mt_kahypar {
   template<typename PartitionedHypergraph>
   struct BalanceAndBestIndexScan {
     const PartitionedHypergraph& phg;
-    const vec<Move>& moves;
+    const ds::ChunkedVector<Move>& moves;
 
     struct Prefix {
       Gain gain = 0;                           /** gain when using valid moves up to best_index */
@@ -71,7 +73,7 @@ namespace mt_kahypar {
 
 
     BalanceAndBestIndexScan(const PartitionedHypergraph& phg,
-                            const vec<Move>& moves,
+                            const ds::ChunkedVector<Move>& moves,
                             const vec<HypernodeWeight>& part_weights,
                             const std::vector<HypernodeWeight>& max_part_weights) :
             phg(phg),
@@ -162,28 +164,38 @@ namespace mt_kahypar {
     const MoveID numMoves = sharedData.moveTracker.numPerformedMoves();
     if (numMoves == 0) return 0;
 
-    const vec<Move>& move_order = sharedData.moveTracker.moveOrder;
+    const ds::ChunkedVector<Move>& move_order = sharedData.moveTracker.moveOrder;
+    utils::Timer& timer = utils::Utilities::instance().getTimer(context.utility_id);
 
+    timer.start_timer("recalculate_gains", "Recalculate Gains");
     recalculateGains(phg, sharedData);
+    timer.stop_timer("recalculate_gains");
     HEAVY_REFINEMENT_ASSERT(verifyGains(phg, sharedData));
 
+    timer.start_timer("find_best_prefix", "Find Best Prefix");
     BalanceAndBestIndexScan<PartitionedHypergraph> s(phg, move_order, partWeights, maxPartWeights);
     // TODO set grain size in blocked_range? to avoid too many copies of part weights array. experiment with different values
     tbb::parallel_scan(tbb::blocked_range<MoveID>(0, numMoves), s);
     typename BalanceAndBestIndexScan<PartitionedHypergraph>::Prefix b = s.finalize(partWeights);
+    timer.stop_timer("find_best_prefix");
 
+    // only the suffix after the best prefix is reverted
+    timer.start_timer("revert_moves", "Revert Moves");
     tbb::parallel_for(b.best_index, numMoves, [&](const MoveID moveID) {
       const Move& m = move_order[moveID];
       if (m.isValid()) {
         moveVertex(phg, m.node, m.to, m.from);
       }
     });
+    timer.stop_timer("revert_moves");
 
     // recompute penalty term values since they are potentially invalid
     if constexpr (GainCache::invalidates_entries) {
+      timer.start_timer("recompute_invalid_terms", "Recompute Invalid Gain Cache Terms");
       tbb::parallel_for(MoveID(0), numMoves, [&](const MoveID i) {
         gain_cache.recomputeInvalidTerms(phg, move_order[i].node);
       });
+      timer.stop_timer("recompute_invalid_terms");
     }
 
     sharedData.moveTracker.reset();
@@ -391,7 +403,26 @@ namespace mt_kahypar {
       tracker.moveOrder[m_id].gain = 0;
     });
 
-    if (context.refinement.fm.iter_moves_on_recalc) {
+    // Iterating over the incident nets of all moved nodes is cheaper than iterating
+    // over all nets, if the moved nodes have fewer incident nets than the hypergraph
+    bool iterate_over_moves = context.refinement.fm.iter_moves_on_recalc;
+    if ( !iterate_over_moves ) {
+      const size_t incident_nets_of_moved_nodes = tbb::parallel_reduce(
+        tbb::blocked_range<MoveID>(MoveID(0), tracker.numPerformedMoves()), UL(0),
+        [&](const tbb::blocked_range<MoveID>& r, size_t sum) {
+          for (MoveID m_id = r.begin(); m_id < r.end(); ++m_id) {
+            sum += phg.nodeDegree(tracker.moveOrder[m_id].node);
+          }
+          return sum;
+        }, std::plus<size_t>());
+      iterate_over_moves = incident_nets_of_moved_nodes < phg.initialNumEdges();
+    }
+
+    if (iterate_over_moves) {
+      if (last_recalc_round.size() < phg.initialNumEdges()) {
+        // allocated on first use, if iter_moves_on_recalc is disabled
+        last_recalc_round.resize(phg.initialNumEdges(), CAtomic<uint32_t>(0));
+      }
       tbb::parallel_for(0U, sharedData.moveTracker.numPerformedMoves(), [&](const MoveID local_move_id) {
         const HypernodeID u = sharedData.moveTracker.moveOrder[local_move_id].node;
         if (tracker.wasNodeMovedInThisRound(u)) {
@@ -424,7 +455,7 @@ namespace mt_kahypar {
 
     GlobalMoveTracker& tracker = sharedData.moveTracker;
     const MoveID numMoves = tracker.numPerformedMoves();
-    const vec<Move>& move_order = tracker.moveOrder;
+    const ds::ChunkedVector<Move>& move_order = tracker.moveOrder;
 
     // revert all moves
     tbb::parallel_for(0U, numMoves, [&](const MoveID localMoveID) {
@@ -497,7 +528,7 @@ namespace mt_kahypar {
 
   template<typename GraphAndGainTypes>
   bool GlobalRollback<GraphAndGainTypes>::verifyGains(PartitionedHypergraph& phg, FMSharedData& sharedData) {
-    vec<Move>& move_order = sharedData.moveTracker.moveOrder;
+    ds::ChunkedVector<Move>& move_order = sharedData.moveTracker.moveOrder;
 
     auto recompute_penalty_terms = [&] {
       for (MoveID localMoveID = 0; localMoveID < sharedData.moveTracker.numPerformedMoves(); ++localMoveID) {
@@ -125,7 +125,7 @@ namespace mt_kahypar {
   template<typename DispatchedFMStrategy>
   void LocalizedKWayFM<GraphAndGainTypes>::internalFindMoves(PartitionedHypergraph& phg,
                                                           DispatchedFMStrategy& fm_strategy) {
-    StopRule stopRule(phg.initialNumNodes());
+    StopRule stopRule(phg.initialNumNodes(), sharedData.stopRuleAlpha);
     Move move;
 
     Gain estimatedImprovement = 0;
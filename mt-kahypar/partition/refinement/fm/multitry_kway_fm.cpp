@@ -55,10 +55,20 @@ namespace mt_kahypar {
     globalRollback(num_hyperedges, context, gainCache),
     ets_fm([&] { return constructLocalizedKWayFMSearch(); }),
     tmp_move_order(num_hypernodes),
+    effort_controller(c),
     rebalancer(rb) {
     if (context.refinement.fm.obey_minimal_parallelism) {
       sharedData.finishedTasksLimit = std::min(UL(8), context.shared_memory.num_threads);
     }
+    finished_tasks_limit = sharedData.finishedTasksLimit;
+    if (context.refinement.fm.numa_aware_seeds &&
+        TBBInitializer::instance().num_used_numa_nodes() > 1) {
+      vec<int> numa_node_of_thread(sharedData.refinementNodes.tls_queues.size());
+      for (size_t thread_id = 0; thread_id < numa_node_of_thread.size(); ++thread_id) {
+        numa_node_of_thread[thread_id] = TBBInitializer::instance().numa_node_of_thread(thread_id);
+      }
+      sharedData.refinementNodes.setNumaNodes(numa_node_of_thread);
+    }
   }
 
   // helper function for rebalancing
@@ -100,7 +110,20 @@ namespace mt_kahypar {
     HighResClockTimepoint fm_start = std::chrono::high_resolution_clock::now();
     utils::Timer& timer = utils::Utilities::instance().getTimer(context.utility_id);
 
-    for (size_t round = 0; round < context.refinement.fm.multitry_rounds; ++round) { // global multi try rounds
+    const bool adaptive_effort = context.refinement.fm.adaptive_effort;
+    size_t max_rounds = context.refinement.fm.multitry_rounds;
+    sharedData.stopRuleAlpha = 1.0;
+    if (adaptive_effort) {
+      effort_controller.startLevel(phg.initialNumPins());
+      max_rounds = std::min(max_rounds, effort_controller.maxRounds());
+      sharedData.stopRuleAlpha = effort_controller.stopRuleAlpha();
+    }
+    size_t num_rounds = 0;
+    bool stopped_by_effort_controller = false;
+
+    for (size_t round = 0; round < max_rounds; ++round) { // global multi try rounds
+      const HighResClockTimepoint round_start = std::chrono::high_resolution_clock::now();
+      ++num_rounds;
       for (PartitionID i = 0; i < context.partition.k; ++i) {
         initialPartWeights[i] = phg.partWeight(i);
       }
@@ -128,10 +151,15 @@ namespace mt_kahypar {
         num_seeds = std::min(num_seeds, context.refinement.fm.num_seed_nodes);
         num_seeds = std::max(num_seeds, UL(1));
       }
+      if (adaptive_effort) {
+        num_seeds = effort_controller.numSeedNodes(num_seeds);
+      }
 
       timer.start_timer("find_moves", "Find Moves");
       size_t num_tasks = std::min(num_border_nodes, size_t(TBBInitializer::instance().total_number_of_threads()));
       sharedData.finishedTasks.store(0, std::memory_order_relaxed);
+      sharedData.finishedTasksLimit = finishedTasksLimit(
+        context.refinement.fm.round_tail_cutoff, num_tasks, finished_tasks_limit);
       fm_strategy->findMoves(utils::localized_fm_cast(ets_fm), hypergraph,
                              num_tasks, num_seeds, round);
       timer.stop_timer("find_moves");
@@ -179,11 +207,21 @@ namespace mt_kahypar {
       fm_strategy->reportImprovement(round, improvement, roundImprovementFraction);
 
       HighResClockTimepoint fm_timestamp = std::chrono::high_resolution_clock::now();
+      if (adaptive_effort) {
+        const double round_time = std::chrono::duration<double>(fm_timestamp - round_start).count();
+        stopped_by_effort_controller = !effort_controller.reportRound(
+          improvement, metrics.quality - (overall_improvement - improvement), round_time);
+      }
       const double elapsed_time = std::chrono::duration<double>(fm_timestamp - fm_start).count();
       if (debug && context.type == ContextType::main) {
         LOG << V(round) << V(improvement) << V(metrics::quality(phg, context))
             << V(metrics::imbalance(phg, context)) << V(num_border_nodes) << V(roundImprovementFraction)
             << V(elapsed_time) << V(current_time_limit);
+        for (size_t node = 0; node < sharedData.refinementNodes.numa_stats.size(); ++node) {
+          const NumaWorkStats& stats = sharedData.refinementNodes.numa_stats[node];
+          LOG << "NUMA node" << node << ":" << V(stats.assigned.load())
+              << V(stats.local_steals.load()) << V(stats.remote_steals.load());
+        }
       }
 
       // Enforce a time limit (based on k and coarsening time).
@@ -204,6 +242,15 @@ namespace mt_kahypar {
             || consecutive_rounds_with_too_little_improvement >= 2 ) {
         break;
       }
+
+      if ( stopped_by_effort_controller ) {
+        DBG << "FM effort controller stops FM on this level:" << V(round) << V(effort_controller.effort());
+        break;
+      }
+    }
+
+    if (adaptive_effort) {
+      effort_controller.finishLevel(num_rounds, stopped_by_effort_controller);
     }
 
     if (context.partition.show_memory_consumption && context.partition.verbose_output
@@ -260,6 +307,16 @@ namespace mt_kahypar {
       });
     }
 
+    // move seeds to the queues of the NUMA node that owns their vertex ID range
+    // (vertex ID ranges are only assigned to NUMA nodes with at least one thread)
+    if (sharedData.refinementNodes.isNumaAware()) {
+      const size_t num_numa_nodes = sharedData.refinementNodes.numNonEmptyNumaNodes();
+      const size_t num_nodes = phg.initialNumNodes();
+      sharedData.refinementNodes.distribute_to_numa_nodes([&](const HypernodeID u) {
+        return static_cast<size_t>(u) * num_numa_nodes / num_nodes;
+      });
+    }
+
     // shuffle task queue if requested
     if (context.refinement.fm.shuffle) {
       sharedData.refinementNodes.shuffle();
@@ -335,7 +392,7 @@ namespace mt_kahypar {
       insert_moves_to_balance_part(part);
     }
 
-    const vec<Move>& move_order = move_tracker.moveOrder;
+    const ds::ChunkedVector<Move>& move_order = move_tracker.moveOrder;
     const MoveID num_moves = move_tracker.numPerformedMoves();
     for (MoveID move_id = 0; move_id < num_moves; ++move_id) {
       const Move& m = move_order[move_id];
@@ -343,7 +400,7 @@ namespace mt_kahypar {
         const HypernodeWeight hn_weight = phg.nodeWeight(m.node);
         current_part_weights[m.from] -= hn_weight;
         current_part_weights[m.to] += hn_weight;
-        tmp_move_order[next_move_index] = m;
+        tmp_move_order.set(next_move_index, m);
         ++next_move_index;
         // insert rebalancing moves if necessary
         insert_moves_to_balance_part(m.to);
@@ -360,7 +417,7 @@ namespace mt_kahypar {
         const MoveID move_index_for_part = current_rebalancing_move_index[part];
         const Move& m = rebalancing_moves_by_part[part][move_index_for_part];
         ++current_rebalancing_move_index[part];
-        tmp_move_order[next_move_index] = m;
+        tmp_move_order.set(next_move_index, m);
         ++next_move_index;
       }
     }
@@ -369,7 +426,7 @@ namespace mt_kahypar {
     const MoveID first_move_id = move_tracker.firstMoveID;
     ASSERT(tmp_move_order.size() == move_tracker.moveOrder.size());
 
-    std::swap(move_tracker.moveOrder, tmp_move_order);
+    move_tracker.moveOrder.swap(tmp_move_order);
     move_tracker.runningMoveID.store(first_move_id + next_move_index);
     tbb::parallel_for(ID(0), next_move_index, [&](const MoveID move_id) {
       const Move& m = move_tracker.moveOrder[move_id];
@@ -392,7 +449,7 @@ namespace mt_kahypar {
       const MoveID move_index_for_block = current_rebalancing_move_index[block];
       const Move& m = rebalancing_moves_by_part[block][move_index_for_block];
       ++current_rebalancing_move_index[block];
-      tmp_move_order[next_move_index] = m;
+      tmp_move_order.set(next_move_index, m);
       ++next_move_index;
       if (m.isValid()) {
         const HypernodeWeight hn_weight = phg.nodeWeight(m.node);
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <cmath>
+
 #include <tbb/enumerable_thread_specific.h>
 
 #include "mt-kahypar/partition/context.h"
@@ -35,6 +37,7 @@
 #include "mt-kahypar/partition/refinement/i_rebalancer.h"
 #include "mt-kahypar/partition/refinement/fm/localized_kway_fm_core.h"
 #include "mt-kahypar/partition/refinement/fm/global_rollback.h"
+#include "mt-kahypar/partition/refinement/fm/fm_effort_controller.h"
 #include "mt-kahypar/partition/refinement/fm/strategies/i_fm_strategy.h"
 #include "mt-kahypar/partition/refinement/gains/gain_cache_ptr.h"
 
@@ -71,6 +74,19 @@ class MultiTryKWayFM final : public IRefiner {
 
   void printMemoryConsumption();
 
+  // ! Number of localized searches that must run out of seed nodes before the
+  // ! remaining searches of a round are stopped. The round tail cutoff in (0, 1]
+  // ! bounds the time the global rollback waits for the slowest searches of a round.
+  static size_t finishedTasksLimit(const double round_tail_cutoff,
+                                   const size_t num_tasks,
+                                   const size_t max_limit) {
+    if (round_tail_cutoff < 1.0) {
+      const size_t limit = static_cast<size_t>(std::ceil(round_tail_cutoff * static_cast<double>(num_tasks)));
+      return std::min(max_limit, std::max(limit, UL(1)));
+    }
+    return max_limit;
+  }
+
  private:
   bool refineImpl(mt_kahypar_partitioned_hypergraph_t& phg,
                   const vec<HypernodeID>& refinement_nodes,
@@ -123,10 +139,12 @@ class MultiTryKWayFM final : public IRefiner {
   GainCache& gain_cache;
   PartitionID current_k;
   FMSharedData sharedData;
+  size_t finished_tasks_limit;
   std::unique_ptr<IFMStrategy> fm_strategy;
   Rollback globalRollback;
   tbb::enumerable_thread_specific<LocalizedFMSearch> ets_fm;
-  vec<Move> tmp_move_order;
+  ds::ChunkedVector<Move> tmp_move_order;
+  FMEffortController effort_controller;
   IRebalancer& rebalancer;
 };
 
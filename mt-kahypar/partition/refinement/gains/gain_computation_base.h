@@ -54,7 +54,8 @@ class GainComputationBase {
     _deltas(0),
     _tmp_scores([&] {
       return constructLocalTmpScores();
-    }) { }
+    }),
+    _he_size_gain_threshold(std::numeric_limits<size_t>::max()) { }
 
   template<typename PartitionedHypergraph>
   Move computeMaxGainMove(const PartitionedHypergraph& phg,
@@ -149,6 +150,12 @@ class GainComputationBase {
     }
   }
 
+  // ! Hyperedges with more pins than the threshold are only evaluated for blocks that
+  // ! are adjacent to the node via smaller hyperedges (if supported by the objective)
+  void setHyperedgeSizeGainThreshold(const size_t threshold) {
+    _he_size_gain_threshold = threshold;
+  }
+
   void changeNumberOfBlocks(const PartitionID new_k) {
     ASSERT(new_k == _context.partition.k);
     for ( auto& tmp_score : _tmp_scores ) {
@@ -169,6 +176,7 @@ private:
   const bool _disable_randomization;
   DeltaGain _deltas;
   TmpScores _tmp_scores;
+  size_t _he_size_gain_threshold;
 };
 
 }  // namespace mt_kahypar
@@ -29,8 +29,10 @@
 #include "tbb/parallel_for.h"
 #include "tbb/enumerable_thread_specific.h"
 #include "tbb/concurrent_vector.h"
+#include "tbb/parallel_scan.h"
 
 #include "mt-kahypar/definitions.h"
+#include "mt-kahypar/parallel/parallel_prefix_sum.h"
 
 namespace mt_kahypar {
 
@@ -40,7 +42,7 @@ void Km1GainCache::initializeGainCache(const PartitionedHypergraph& partitioned_
   ASSERT(_k <= 0 || _k >= partitioned_hg.k(),
     "Gain cache was already initialized for a different k" << V(_k) << V(partitioned_hg.k()));
   allocateGainTable(partitioned_hg.topLevelNumNodes(), partitioned_hg.k());
-
+  initializeLargeHyperedges(partitioned_hg);
 
   // Gain calculation consist of two stages
   //  1. Compute gain of all low degree vertices
@@ -54,7 +56,9 @@ void Km1GainCache::initializeGainCache(const PartitionedHypergraph& partitioned_
       for (HypernodeID u = r.begin(); u < r.end(); ++u) {
         if ( partitioned_hg.nodeIsEnabled(u)) {
           if ( partitioned_hg.nodeDegree(u) <= HIGH_DEGREE_THRESHOLD) {
-            initializeGainCacheEntryForNode(partitioned_hg, u, benefit_aggregator);
+            if ( !_lazy_initialization || !initializeGainCacheEntryForInteriorNode(partitioned_hg, u) ) {
+              initializeGainCacheEntryForNode(partitioned_hg, u, benefit_aggregator);
+            }
           } else {
             // Collect high degree vertices
             high_degree_vertices.push_back(u);
@@ -68,6 +72,9 @@ void Km1GainCache::initializeGainCache(const PartitionedHypergraph& partitioned_
         const HyperedgeID he,
         HyperedgeWeight& penalty_aggregator,
         vec<HyperedgeWeight>& benefit_aggregator) {
+    if ( isLargeHyperedge(partitioned_hg.edgeSize(he)) ) {
+      return;
+    }
     HyperedgeWeight edge_weight = partitioned_hg.edgeWeight(he);
     if (partitioned_hg.pinCountInPart(he, block_of_u) > 1) {
       penalty_aggregator += edge_weight;
@@ -101,19 +108,96 @@ void Km1GainCache::initializeGainCache(const PartitionedHypergraph& partitioned_
     // Aggregate thread locals to compute overall gain of the high degree vertex
     const HyperedgeWeight penalty_term = ets_mfp.combine(std::plus<HyperedgeWeight>());
     _gain_cache[penalty_index(u)].store(penalty_term, std::memory_order_relaxed);
+    if ( _track_adjacent_blocks ) {
+      _adjacent_blocks.clear(u);
+    }
     for (PartitionID p = 0; p < _k; ++p) {
       HyperedgeWeight move_to_benefit = 0;
       for ( auto& l_move_to_benefit : ets_mtb ) {
         move_to_benefit += l_move_to_benefit[p];
         l_move_to_benefit[p] = 0;
       }
-      _gain_cache[benefit_index(u, p)].store(move_to_benefit, std::memory_order_relaxed);
+      initializeBenefit(u, p, move_to_benefit);
+    }
+    if ( _lazy_initialization ) {
+      _interior_block[u].store(MATERIALIZED, std::memory_order_relaxed);
     }
   }
 
   _is_initialized = true;
 }
 
+template<typename PartitionedHypergraph>
+void Km1GainCache::initializeLargeHyperedges(const PartitionedHypergraph& partitioned_hg) {
+  _large_hes.clear();
+  _large_he_weights.clear();
+  _large_he_pin_counts.clear();
+  _large_he_offsets.clear();
+  _incident_large_hes.clear();
+  if constexpr ( PartitionedHypergraph::is_graph ) {
+    // Edges of graphs have two pins and their pin counts are not
+    // passed to notifyBeforeDeltaGainUpdate(...)
+    _large_he_threshold = std::numeric_limits<HypernodeID>::max();
+  }
+  if ( _large_he_threshold == std::numeric_limits<HypernodeID>::max() ) {
+    return;
+  }
+
+  tbb::concurrent_vector<HyperedgeID> large_hes;
+  partitioned_hg.doParallelForAllEdges([&](const HyperedgeID& he) {
+    if ( isLargeHyperedge(partitioned_hg.edgeSize(he)) ) {
+      large_hes.push_back(he);
+    }
+  });
+  if ( large_hes.empty() ) {
+    return;
+  }
+
+  _large_hes.assign(large_hes.begin(), large_hes.end());
+  std::sort(_large_hes.begin(), _large_hes.end());
+  _large_he_weights.resize(_large_hes.size());
+  _large_he_pin_counts.resize(_large_hes.size() * _k);
+  tbb::parallel_for(UL(0), _large_hes.size(), [&](const size_t large_he) {
+    const HyperedgeID he = _large_hes[large_he];
+    _large_he_weights[large_he] = partitioned_hg.edgeWeight(he);
+    for ( PartitionID block = 0; block < _k; ++block ) {
+      _large_he_pin_counts[large_pin_count_index(large_he, block)].store(
+        block < partitioned_hg.k() ? std::min(partitioned_hg.pinCountInPart(he, block), ID(2)) : 0,
+        std::memory_order_relaxed);
+    }
+  });
+
+  // Build incidence array that stores the large nets of each node
+  const HypernodeID num_nodes = partitioned_hg.initialNumNodes();
+  _large_he_offsets.assign(num_nodes + 1, 0);
+  tbb::parallel_for(ID(0), num_nodes, [&](const HypernodeID u) {
+    if ( partitioned_hg.nodeIsEnabled(u) ) {
+      size_t num_large_hes = 0;
+      for ( const HyperedgeID& he : partitioned_hg.incidentEdges(u) ) {
+        num_large_hes += isLargeHyperedge(partitioned_hg.edgeSize(he));
+      }
+      _large_he_offsets[u + 1] = num_large_hes;
+    }
+  });
+  parallel::TBBPrefixSum<size_t> prefix_sum(_large_he_offsets);
+  tbb::parallel_scan(tbb::blocked_range<size_t>(UL(0), _large_he_offsets.size()), prefix_sum);
+  _incident_large_hes.resize(_large_he_offsets.back());
+  tbb::parallel_for(ID(0), num_nodes, [&](const HypernodeID u) {
+    size_t pos = _large_he_offsets[u];
+    if ( partitioned_hg.nodeIsEnabled(u) ) {
+      for ( const HyperedgeID& he : partitioned_hg.incidentEdges(u) ) {
+        if ( isLargeHyperedge(partitioned_hg.edgeSize(he)) ) {
+          _incident_large_hes[pos++] = largeHyperedgeIndex(he);
+        }
+      }
+    }
+    ASSERT(pos == _large_he_offsets[u + 1]);
+  });
+
+  DBG << "Excluded" << _large_hes.size() << "nets with more than" << _large_he_threshold
+      << "pins from the gain cache (" << _incident_large_hes.size() << "pins)";
+}
+
 bool Km1GainCache::triggersDeltaGainUpdate(const SynchronizedEdgeUpdate& sync_update) {
   return sync_update.pin_count_in_from_part_after == 0 ||
          sync_update.pin_count_in_from_part_after == 1 ||
@@ -131,6 +215,12 @@ void Km1GainCache::deltaGainUpdate(const PartitionedHypergraph& partitioned_hg,
   const HyperedgeWeight edge_weight = sync_update.edge_weight;
   const HypernodeID pin_count_in_from_part_after = sync_update.pin_count_in_from_part_after;
   const HypernodeID pin_count_in_to_part_after = sync_update.pin_count_in_to_part_after;
+  if ( isLargeHyperedge(sync_update.edge_size) ) {
+    // The contribution of large nets is computed on demand from their pin counts,
+    // which are updated in notifyBeforeDeltaGainUpdate(...) while the net is locked.
+    return;
+  }
+
   if ( pin_count_in_from_part_after == 1 ) {
     for (const HypernodeID& u : partitioned_hg.pins(he)) {
       ASSERT(nodeGainAssertions(u, from));
@@ -141,14 +231,16 @@ void Km1GainCache::deltaGainUpdate(const PartitionedHypergraph& partitioned_hg,
   } else if (pin_count_in_from_part_after == 0) {
     for (const HypernodeID& u : partitioned_hg.pins(he)) {
       ASSERT(nodeGainAssertions(u, from));
-      _gain_cache[benefit_index(u, from)].fetch_sub(edge_weight, std::memory_order_relaxed);
+      materializeGainCacheEntry(u);
+      decreaseBenefit(u, from, edge_weight);
     }
   }
 
   if (pin_count_in_to_part_after == 1) {
     for (const HypernodeID& u : partitioned_hg.pins(he)) {
       ASSERT(nodeGainAssertions(u, to));
-      _gain_cache[benefit_index(u, to)].fetch_add(edge_weight, std::memory_order_relaxed);
+      materializeGainCacheEntry(u);
+      increaseBenefit(u, to, edge_weight);
     }
   } else if (pin_count_in_to_part_after == 2) {
     for (const HypernodeID& u : partitioned_hg.pins(he)) {
@@ -236,6 +328,34 @@ void Km1GainCache::restoreSinglePinHyperedge(const HypernodeID u,
   }
 }
 
+template<typename PartitionedHypergraph>
+bool Km1GainCache::initializeGainCacheEntryForInteriorNode(const PartitionedHypergraph& partitioned_hg,
+                                                           const HypernodeID u) {
+  const PartitionID from = partitioned_hg.partID(u);
+  Gain penalty = 0;
+  Gain benefit = 0;
+  for (const HyperedgeID& e : partitioned_hg.incidentEdges(u)) {
+    if ( partitioned_hg.connectivity(e) > 1 ) {
+      return false;
+    }
+    if ( !isLargeHyperedge(partitioned_hg.edgeSize(e)) ) {
+      const HyperedgeWeight ew = partitioned_hg.edgeWeight(e);
+      if ( partitioned_hg.pinCountInPart(e, from) > 1 ) {
+        penalty += ew;
+      }
+      benefit += ew;
+    }
+  }
+
+  _gain_cache[penalty_index(u)].store(penalty, std::memory_order_relaxed);
+  if ( _track_adjacent_blocks ) {
+    _adjacent_blocks.clear(u);
+  }
+  initializeBenefit(u, from, benefit);
+  _interior_block[u].store(from, std::memory_order_relaxed);
+  return true;
+}
+
 template<typename PartitionedHypergraph>
 void Km1GainCache::initializeGainCacheEntryForNode(const PartitionedHypergraph& partitioned_hg,
                                                   const HypernodeID u,
@@ -243,6 +363,9 @@ void Km1GainCache::initializeGainCacheEntryForNode(const PartitionedHypergraph&
   PartitionID from = partitioned_hg.partID(u);
   Gain penalty = 0;
   for (const HyperedgeID& e : partitioned_hg.incidentEdges(u)) {
+    if ( isLargeHyperedge(partitioned_hg.edgeSize(e)) ) {
+      continue;
+    }
     HyperedgeWeight ew = partitioned_hg.edgeWeight(e);
     if ( partitioned_hg.pinCountInPart(e, from) > 1 ) {
       penalty += ew;
@@ -253,10 +376,16 @@ void Km1GainCache::initializeGainCacheEntryForNode(const PartitionedHypergraph&
   }
 
   _gain_cache[penalty_index(u)].store(penalty, std::memory_order_relaxed);
+  if ( _track_adjacent_blocks ) {
+    _adjacent_blocks.clear(u);
+  }
   for (PartitionID i = 0; i < _k; ++i) {
-    _gain_cache[benefit_index(u, i)].store(benefit_aggregator[i], std::memory_order_relaxed);
+    initializeBenefit(u, i, benefit_aggregator[i]);
     benefit_aggregator[i] = 0;
   }
+  if ( _lazy_initialization ) {
+    _interior_block[u].store(MATERIALIZED, std::memory_order_relaxed);
+  }
 }
 
 namespace {
@@ -272,6 +401,9 @@ namespace {
                                                                                       const HypernodeID,   \
                                                                                       const HypernodeID,   \
                                                                                       const HyperedgeID)
+#define KM1_INIT_LARGE_HYPEREDGES(X) void Km1GainCache::initializeLargeHyperedges(const X&)
+#define KM1_INIT_INTERIOR_GAIN_CACHE_ENTRY(X) bool Km1GainCache::initializeGainCacheEntryForInteriorNode(const X&,          \
+                                                                                                         const HypernodeID)
 #define KM1_INIT_GAIN_CACHE_ENTRY(X) void Km1GainCache::initializeGainCacheEntryForNode(const X&,           \
                                                                                         const HypernodeID,  \
                                                                                         vec<Gain>&)
@@ -282,5 +414,7 @@ INSTANTIATE_FUNC_WITH_PARTITIONED_HG(KM1_DELTA_GAIN_UPDATE)
 INSTANTIATE_FUNC_WITH_PARTITIONED_HG(KM1_RESTORE_UPDATE)
 INSTANTIATE_FUNC_WITH_PARTITIONED_HG(KM1_REPLACEMENT_UPDATE)
 INSTANTIATE_FUNC_WITH_PARTITIONED_HG(KM1_INIT_GAIN_CACHE_ENTRY)
+INSTANTIATE_FUNC_WITH_PARTITIONED_HG(KM1_INIT_INTERIOR_GAIN_CACHE_ENTRY)
+INSTANTIATE_FUNC_WITH_PARTITIONED_HG(KM1_INIT_LARGE_HYPEREDGES)
 
 }  // namespace mt_kahypar
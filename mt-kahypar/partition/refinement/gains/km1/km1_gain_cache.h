@@ -30,10 +30,12 @@
 
 #include "kahypar-resources/meta/policy_registry.h"
 
-#include "mt-kahypar/partition/context_enum_classes.h"
+#include "mt-kahypar/partition/context.h"
 #include "mt-kahypar/datastructures/hypergraph_common.h"
 #include "mt-kahypar/datastructures/array.h"
 #include "mt-kahypar/datastructures/sparse_map.h"
+#include "mt-kahypar/datastructures/connectivity_set.h"
+#include "mt-kahypar/datastructures/delta_connectivity_set.h"
 #include "mt-kahypar/parallel/atomic_wrapper.h"
 #include "mt-kahypar/macros.h"
 #include "mt-kahypar/utils/range.h"
@@ -60,17 +62,41 @@ namespace mt_kahypar {
  *            = b(u, V_j) - p(u)
  * We call b(u, V_j) the benefit term and p(u) the penalty term. Our gain cache stores and maintains these
  * entries for each node and block. Thus, the gain cache stores k + 1 entries per node.
+ *
+ * Maintaining the cached entries requires iterating over all pins of a net each time its pin count
+ * in a block changes from or to 0, 1 or 2. For nets with several thousand pins, this is expensive and
+ * serializes the local searches. Therefore, nets with a size larger than a configurable threshold are
+ * excluded from the cached terms. Instead, we maintain the pin counts of these nets capped at two
+ * (which is all that is required to decide whether a net contributes to b(u, V_j) or p(u)) and add
+ * their contribution to the benefit and penalty terms on demand when querying the gain of a node.
+ * Moving a pin of a large net then only updates two counters instead of touching all of its pins.
+ *
+ * Optionally, the gain cache can be initialized lazily. In this case, we only write the penalty term and
+ * the benefit term of the own block for interior nodes (all incident nets are internal). All other benefit
+ * terms of an interior node are zero and materialized when the first delta gain update modifies
+ * a benefit term of the node. Thus, interior nodes never touch their k benefit entries.
+ *
+ * By default, the gain cache reports all k blocks as adjacent to a node, which means that searching
+ * for the best target block scans the full row of k benefit terms. Optionally, the gain cache tracks
+ * the blocks with a non-zero (cached) benefit term of each node in a bitset. A block becomes adjacent
+ * to a node when its benefit term increases from zero and is removed when it drops back to zero.
+ * The benefit terms are still stored densely, but best move selection then only visits adjacent blocks.
+ * Note that blocks that are only connected to a node via large nets (see above) are not reported.
 */
 class Km1GainCache {
 
+  static constexpr bool debug = false;
   static constexpr HyperedgeID HIGH_DEGREE_THRESHOLD = ID(100000);
+  // ! Marks a node whose gain cache entries are materialized (see _interior_block)
+  static constexpr PartitionID MATERIALIZED = kInvalidPartition;
 
-  using AdjacentBlocksIterator = IntegerRangeIterator<PartitionID>::const_iterator;
+  using Block = ds::StaticBitset::Block;
+  using AdjacentBlocksIterator = typename ds::DeltaConnectivitySet<ds::ConnectivitySets>::Iterator;
 
  public:
 
   static constexpr GainPolicy TYPE = GainPolicy::km1;
-  static constexpr bool requires_notification_before_update = false;
+  static constexpr bool requires_notification_before_update = true;
   static constexpr bool initializes_gain_cache_entry_after_batch_uncontractions = false;
   static constexpr bool invalidates_entries = true;
 
@@ -78,13 +104,41 @@ class Km1GainCache {
     _is_initialized(false),
     _k(kInvalidPartition),
     _gain_cache(),
-    _dummy_adjacent_blocks() { }
-
-  Km1GainCache(const Context&) :
+    _track_adjacent_blocks(false),
+    _adjacent_blocks(),
+    _all_blocks(),
+    _no_blocks(),
+    _lazy_initialization(false),
+    _interior_block(),
+    _large_he_threshold(std::numeric_limits<HypernodeID>::max()),
+    _large_hes(),
+    _large_he_weights(),
+    _large_he_pin_counts(),
+    _large_he_offsets(),
+    _incident_large_hes() { }
+
+  Km1GainCache(const Context& context) :
     _is_initialized(false),
     _k(),
     _gain_cache(),
-    _dummy_adjacent_blocks() { }
+    _track_adjacent_blocks(!context.isNLevelPartitioning() &&
+      context.refinement.gain_cache_track_adjacent_blocks),
+    _adjacent_blocks(),
+    _all_blocks(),
+    _no_blocks(),
+    // In n-level partitioning, nets change their size during uncontractions.
+    // We therefore always cache the contribution of all nets in this case
+    // and also initialize all entries eagerly.
+    _lazy_initialization(!context.isNLevelPartitioning() &&
+      context.refinement.lazy_gain_cache_initialization),
+    _interior_block(),
+    _large_he_threshold(context.isNLevelPartitioning() ?
+      std::numeric_limits<HypernodeID>::max() : context.refinement.gain_cache_large_he_threshold),
+    _large_hes(),
+    _large_he_weights(),
+    _large_he_pin_counts(),
+    _large_he_offsets(),
+    _incident_large_hes() { }
 
   Km1GainCache(const Km1GainCache&) = delete;
   Km1GainCache & operator= (const Km1GainCache &) = delete;
@@ -98,6 +152,12 @@ class Km1GainCache {
     return _is_initialized;
   }
 
+  // ! Returns whether the partitioned (hyper)graph has to call notifyBeforeDeltaGainUpdate(...).
+  // ! This is only the case if there are large nets whose capped pin counts must be updated.
+  bool requiresNotificationBeforeUpdate() const {
+    return !_large_hes.empty();
+  }
+
   void reset(const bool run_parallel = true) {
     unused(run_parallel);
     _is_initialized = false;
@@ -107,6 +167,18 @@ class Km1GainCache {
     return _gain_cache.size();
   }
 
+  // ! Returns the number of nets that are excluded from the cached terms
+  size_t numLargeHyperedges() const {
+    return _large_hes.size();
+  }
+
+  // ! Returns true, if the benefit terms of node u are stored in the gain cache. With lazy
+  // ! initialization, this is not the case for interior nodes whose entries were never updated.
+  bool isMaterialized(const HypernodeID u) const {
+    return !_lazy_initialization ||
+      _interior_block[u].load(std::memory_order_acquire) == MATERIALIZED;
+  }
+
   // ! Initializes all gain cache entries
   template<typename PartitionedHypergraph>
   void initializeGainCache(const PartitionedHypergraph& partitioned_hg);
@@ -117,11 +189,14 @@ class Km1GainCache {
     // Do nothing
   }
 
-  IteratorRange<AdjacentBlocksIterator> adjacentBlocks(const HypernodeID) const {
-    // We do not maintain the adjacent blocks of a node in this gain cache.
-    // We therefore return an iterator over all blocks here
+  IteratorRange<AdjacentBlocksIterator> adjacentBlocks(const HypernodeID hn) const {
+    // If we do not track the adjacent blocks of a node, we return an iterator over all blocks
+    const Block* adjacent_blocks = _track_adjacent_blocks ?
+      _adjacent_blocks.shallowCopy(hn).data() : _all_blocks.data();
     return IteratorRange<AdjacentBlocksIterator>(
-      _dummy_adjacent_blocks.cbegin(), _dummy_adjacent_blocks.cend());
+      AdjacentBlocksIterator(_no_blocks.size(), adjacent_blocks, _no_blocks.data(), -1),
+      AdjacentBlocksIterator(_no_blocks.size(), adjacent_blocks, _no_blocks.data(),
+        static_cast<PartitionID>(_no_blocks.size() * ds::StaticBitset::BITS_PER_BLOCK)));
   }
 
   // ####################### Gain Computation #######################
@@ -130,9 +205,12 @@ class Km1GainCache {
   // ! More formally, p(u) := w({ e \in I(u) | pin_count(e, V_i) > 1 })
   MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
   HyperedgeWeight penaltyTerm(const HypernodeID u,
-                              const PartitionID /* only relevant for graphs */) const {
+                              const PartitionID from) const {
     ASSERT(_is_initialized, "Gain cache is not initialized");
-    return _gain_cache[penalty_index(u)].load(std::memory_order_relaxed);
+    return _gain_cache[penalty_index(u)].load(std::memory_order_relaxed) +
+      penaltyTermOfLargeHyperedges(u, from, [&](const size_t large_he, const PartitionID block) {
+        return _large_he_pin_counts[large_pin_count_index(large_he, block)].load(std::memory_order_relaxed);
+      });
   }
 
   // ! Recomputes the penalty term entry in the gain cache
@@ -141,7 +219,7 @@ class Km1GainCache {
   void recomputeInvalidTerms(const PartitionedHypergraph& partitioned_hg,
                              const HypernodeID u) {
     ASSERT(_is_initialized, "Gain cache is not initialized");
-    _gain_cache[penalty_index(u)].store(recomputePenaltyTerm(
+    _gain_cache[penalty_index(u)].store(recomputeCachedPenaltyTerm(
       partitioned_hg, u), std::memory_order_relaxed);
   }
 
@@ -150,6 +228,34 @@ class Km1GainCache {
   MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
   HyperedgeWeight benefitTerm(const HypernodeID u, const PartitionID to) const {
     ASSERT(_is_initialized, "Gain cache is not initialized");
+    return cachedBenefitTerm(u, to) +
+      benefitTermOfLargeHyperedges(u, to, [&](const size_t large_he, const PartitionID block) {
+        return _large_he_pin_counts[large_pin_count_index(large_he, block)].load(std::memory_order_relaxed);
+      });
+  }
+
+  // ! Returns the penalty term of node u stored in the gain cache,
+  // ! which excludes the contribution of large nets
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  HyperedgeWeight cachedPenaltyTerm(const HypernodeID u) const {
+    return _gain_cache[penalty_index(u)].load(std::memory_order_relaxed);
+  }
+
+  // ! Returns the benefit term of node u for block to stored in the gain cache.
+  // ! If the entries of u are not materialized, u is an interior node and all
+  // ! benefit terms except the one of its own block are zero.
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  HyperedgeWeight cachedBenefitTerm(const HypernodeID u, const PartitionID to) const {
+    if ( _lazy_initialization ) {
+      const PartitionID state = _interior_block[u].load(std::memory_order_acquire);
+      if ( state != MATERIALIZED ) {
+        // A negative state indicates that another thread currently materializes the entries
+        const PartitionID block = state >= 0 ? state : -state - 2;
+        if ( block != to ) {
+          return 0;
+        }
+      }
+    }
     return _gain_cache[benefit_index(u, to)].load(std::memory_order_relaxed);
   }
 
@@ -157,10 +263,10 @@ class Km1GainCache {
   // ! More formally, g(u, V_j) := b(u, V_j) - p(u).
   MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
   HyperedgeWeight gain(const HypernodeID u,
-                       const PartitionID, /* only relevant for graphs */
+                       const PartitionID from,
                        const PartitionID to ) const {
     ASSERT(_is_initialized, "Gain cache is not initialized");
-    return benefitTerm(u, to) - penaltyTerm(u, kInvalidPartition);
+    return benefitTerm(u, to) - penaltyTerm(u, from);
   }
 
   // ####################### Delta Gain Update #######################
@@ -173,9 +279,17 @@ class Km1GainCache {
   // ! data structures before calling the delta gain update function. The partitioned
   // ! (hyper)graph holds a lock for the corresponding (hyper)edge when calling this
   // ! function. Thus, it is guaranteed that no other thread will modify the hyperedge.
+  // ! We use this to update the capped pin counts of large nets, since the pin count updates
+  // ! of concurrent moves on the same net must be applied in the order in which they happen.
   template<typename PartitionedHypergraph>
-  void notifyBeforeDeltaGainUpdate(const PartitionedHypergraph&, const SynchronizedEdgeUpdate&) {
-    // Do nothing
+  void notifyBeforeDeltaGainUpdate(const PartitionedHypergraph&, const SynchronizedEdgeUpdate& sync_update) {
+    if ( isLargeHyperedge(sync_update.edge_size) ) {
+      const size_t large_he = largeHyperedgeIndex(sync_update.he);
+      _large_he_pin_counts[large_pin_count_index(large_he, sync_update.from)].store(
+        std::min(sync_update.pin_count_in_from_part_after, ID(2)), std::memory_order_relaxed);
+      _large_he_pin_counts[large_pin_count_index(large_he, sync_update.to)].store(
+        std::min(sync_update.pin_count_in_to_part_after, ID(2)), std::memory_order_relaxed);
+    }
   }
 
   // ! This functions implements the delta gain updates for the connecitivity metric.
@@ -257,7 +371,7 @@ class Km1GainCache {
 
   void changeNumberOfBlocks(const PartitionID new_k) {
     ASSERT(new_k <= _k);
-    _dummy_adjacent_blocks = IntegerRangeIterator<PartitionID>(new_k);
+    initializeAllBlocks(new_k);
   }
 
   template<typename PartitionedHypergraph>
@@ -279,17 +393,195 @@ class Km1GainCache {
     return size_t(u) * ( _k + 1 )  + p + 1;
   }
 
+  // ! Materializes the benefit terms of an interior node. Must be called before
+  // ! modifying a benefit term of node u in the gain cache.
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  void materializeGainCacheEntry(const HypernodeID u) {
+    if ( _lazy_initialization ) {
+      PartitionID state = _interior_block[u].load(std::memory_order_acquire);
+      while ( state != MATERIALIZED ) {
+        if ( state >= 0 && _interior_block[u].compare_exchange_strong(
+               state, -state - 2, std::memory_order_acq_rel) ) {
+          // Benefit term of the own block is already initialized
+          for ( PartitionID p = 0; p < _k; ++p ) {
+            if ( p != state ) {
+              _gain_cache[benefit_index(u, p)].store(0, std::memory_order_relaxed);
+            }
+          }
+          _interior_block[u].store(MATERIALIZED, std::memory_order_release);
+          return;
+        }
+        // Wait until other thread has materialized the entries
+        state = _interior_block[u].load(std::memory_order_acquire);
+      }
+    }
+  }
+
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  size_t large_pin_count_index(const size_t large_he, const PartitionID p) const {
+    return large_he * _k + p;
+  }
+
+  // ! Returns the index of a large net in the internal large net data structures
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  size_t largeHyperedgeIndex(const HyperedgeID he) const {
+    ASSERT(std::binary_search(_large_hes.cbegin(), _large_hes.cend(), he));
+    return std::lower_bound(_large_hes.cbegin(), _large_hes.cend(), he) - _large_hes.cbegin();
+  }
+
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  bool isLargeHyperedge(const HypernodeID edge_size) const {
+    return edge_size > _large_he_threshold;
+  }
+
+  // ! Contribution of the large nets of node u to its penalty term. The (capped) pin counts of the
+  // ! large nets are provided by the function pin_count(large_he, block), which allows the delta gain
+  // ! cache to pass its thread-local view on the pin counts.
+  template<typename PinCountFunc>
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  HyperedgeWeight penaltyTermOfLargeHyperedges(const HypernodeID u,
+                                               const PartitionID from,
+                                               const PinCountFunc& pin_count) const {
+    HyperedgeWeight penalty = 0;
+    if ( !_large_hes.empty() ) {
+      ASSERT(from != kInvalidPartition && from < _k);
+      for ( size_t pos = _large_he_offsets[u]; pos < _large_he_offsets[u + 1]; ++pos ) {
+        const size_t large_he = _incident_large_hes[pos];
+        if ( pin_count(large_he, from) > 1 ) {
+          penalty += _large_he_weights[large_he];
+        }
+      }
+    }
+    return penalty;
+  }
+
+  // ! Contribution of the large nets of node u to its benefit term for block to
+  template<typename PinCountFunc>
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  HyperedgeWeight benefitTermOfLargeHyperedges(const HypernodeID u,
+                                               const PartitionID to,
+                                               const PinCountFunc& pin_count) const {
+    HyperedgeWeight benefit = 0;
+    if ( !_large_hes.empty() ) {
+      for ( size_t pos = _large_he_offsets[u]; pos < _large_he_offsets[u + 1]; ++pos ) {
+        const size_t large_he = _incident_large_hes[pos];
+        if ( pin_count(large_he, to) >= 1 ) {
+          benefit += _large_he_weights[large_he];
+        }
+      }
+    }
+    return benefit;
+  }
+
+  // ! Recomputes the penalty term of node u that is stored in the gain cache
+  // ! (excludes the contribution of large nets)
+  template<typename PartitionedHypergraph>
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  HyperedgeWeight recomputeCachedPenaltyTerm(const PartitionedHypergraph& partitioned_hg,
+                                             const HypernodeID u) const {
+    const PartitionID block_of_u = partitioned_hg.partID(u);
+    HyperedgeWeight penalty = 0;
+    for (HyperedgeID e : partitioned_hg.incidentEdges(u)) {
+      if ( !isLargeHyperedge(partitioned_hg.edgeSize(e)) &&
+           partitioned_hg.pinCountInPart(e, block_of_u) > 1 ) {
+        penalty += partitioned_hg.edgeWeight(e);
+      }
+    }
+    return penalty;
+  }
+
+  // ! Collects all nets larger than the threshold, initializes their pin counts and
+  // ! builds the incidence array that stores for each node its incident large nets
+  template<typename PartitionedHypergraph>
+  void initializeLargeHyperedges(const PartitionedHypergraph& partitioned_hg);
+
   // ! Allocates the memory required to store the gain cache
   void allocateGainTable(const HypernodeID num_nodes,
                          const PartitionID k) {
     if (_gain_cache.size() == 0 && k != kInvalidPartition) {
       _k = k;
-      _dummy_adjacent_blocks = IntegerRangeIterator<PartitionID>(k);
+      initializeAllBlocks(k);
       _gain_cache.resize(
         "Refinement", "gain_cache", num_nodes * size_t(_k + 1), true);
+      if ( _lazy_initialization ) {
+        _interior_block.resize("Refinement", "gain_cache_interior_block", num_nodes);
+      }
+      if ( _track_adjacent_blocks ) {
+        _adjacent_blocks = ds::ConnectivitySets(num_nodes, k, true);
+      }
+    }
+  }
+
+  // ! Initializes the bitset containing all blocks (returned as adjacent blocks if we
+  // ! do not track them) and the empty bitset (used as thread-local delta for iteration)
+  void initializeAllBlocks(const PartitionID k) {
+    const size_t num_blocks = k / ds::StaticBitset::BITS_PER_BLOCK +
+      (k % ds::StaticBitset::BITS_PER_BLOCK != 0);
+    _all_blocks.assign(num_blocks, 0);
+    _no_blocks.assign(num_blocks, 0);
+    for ( PartitionID p = 0; p < k; ++p ) {
+      _all_blocks[p / ds::StaticBitset::BITS_PER_BLOCK] |=
+        Block(1) << (p % ds::StaticBitset::BITS_PER_BLOCK);
+    }
+  }
+
+  // ! Adds w to the benefit term of node u for block to and
+  // ! updates the adjacent blocks of u
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  void increaseBenefit(const HypernodeID u, const PartitionID to, const HyperedgeWeight w) {
+    const HyperedgeWeight benefit_before =
+      _gain_cache[benefit_index(u, to)].fetch_add(w, std::memory_order_relaxed);
+    if ( _track_adjacent_blocks ) {
+      toggleAdjacentBlockOnZeroCrossing(u, to, benefit_before, benefit_before + w);
+    }
+  }
+
+  // ! Subtracts w from the benefit term of node u for block to and
+  // ! updates the adjacent blocks of u
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  void decreaseBenefit(const HypernodeID u, const PartitionID to, const HyperedgeWeight w) {
+    const HyperedgeWeight benefit_after =
+      _gain_cache[benefit_index(u, to)].sub_fetch(w, std::memory_order_relaxed);
+    if ( _track_adjacent_blocks ) {
+      toggleAdjacentBlockOnZeroCrossing(u, to, benefit_after + w, benefit_after);
+    }
+  }
+
+  // ! The delta gain updates are applied after the net lock is released. Thus, concurrent
+  // ! updates can temporarily make a benefit term negative (e.g., 0 -> -w -> w'). Since the
+  // ! adjacent blocks are stored as toggle bits, we flip the bit whenever the benefit term
+  // ! changes from zero to non-zero or vice versa. The atomic updates of the benefit term
+  // ! are linearizable, so the bit is set if and only if the final benefit term is non-zero.
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  void toggleAdjacentBlockOnZeroCrossing(const HypernodeID u,
+                                         const PartitionID to,
+                                         const HyperedgeWeight benefit_before,
+                                         const HyperedgeWeight benefit_after) {
+    if ( ( benefit_before == 0 ) != ( benefit_after == 0 ) ) {
+      if ( benefit_before == 0 ) {
+        _adjacent_blocks.add(u, to);
+      } else {
+        _adjacent_blocks.remove(u, to);
+      }
     }
   }
 
+  // ! Stores the benefit term of node u for block to (not thread-safe
+  // ! for the same node) and updates the adjacent blocks of u
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  void initializeBenefit(const HypernodeID u, const PartitionID to, const HyperedgeWeight benefit) {
+    _gain_cache[benefit_index(u, to)].store(benefit, std::memory_order_relaxed);
+    if ( _track_adjacent_blocks && benefit != 0 ) {
+      _adjacent_blocks.add(u, to);
+    }
+  }
+
+  // ! Initializes the penalty term and the benefit term of the own block for node u,
+  // ! if u is an interior node. Returns false, if u is a border node.
+  template<typename PartitionedHypergraph>
+  bool initializeGainCacheEntryForInteriorNode(const PartitionedHypergraph& partitioned_hg,
+                                               const HypernodeID u);
+
   // ! Initializes the benefit and penalty terms for a node u
   template<typename PartitionedHypergraph>
   MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
@@ -322,8 +614,38 @@ class Km1GainCache {
   // ! Array of size |V| * (k + 1), which stores the benefit and penalty terms of each node.
   ds::Array< CAtomic<HyperedgeWeight> > _gain_cache;
 
-  // ! Provides an iterator from 0 to k (:= number of blocks)
-  IntegerRangeIterator<PartitionID> _dummy_adjacent_blocks;
+  // ! If true, we track the blocks with a non-zero benefit term of each node
+  bool _track_adjacent_blocks;
+
+  // ! Stores the adjacent blocks of each node (only used if we track them)
+  ds::ConnectivitySets _adjacent_blocks;
+
+  // ! Bitset containing all blocks and empty bitset (both with k bits)
+  vec<Block> _all_blocks;
+  vec<Block> _no_blocks;
+
+  // ! If true, benefit terms of interior nodes are materialized on first update
+  bool _lazy_initialization;
+
+  // ! Stores for each node with non-materialized entries its block (or -(block + 2) while
+  // ! materializing), and MATERIALIZED otherwise. Only used for lazy initialization.
+  ds::Array< CAtomic<PartitionID> > _interior_block;
+
+  // ! Nets with a size larger than this threshold are not part of the cached terms
+  HypernodeID _large_he_threshold;
+
+  // ! Sorted IDs of all nets larger than the threshold
+  vec<HyperedgeID> _large_hes;
+
+  // ! Weights of the large nets
+  vec<HyperedgeWeight> _large_he_weights;
+
+  // ! Pin counts of the large nets capped at two (|large nets| * k entries)
+  vec<CAtomic<HypernodeID>> _large_he_pin_counts;
+
+  // ! Incidence array that stores for each node the indices of its incident large nets
+  vec<size_t> _large_he_offsets;
+  vec<uint32_t> _incident_large_hes;
 };
 
 /**
@@ -344,30 +666,45 @@ class DeltaKm1GainCache {
 
   DeltaKm1GainCache(const Km1GainCache& gain_cache) :
     _gain_cache(gain_cache),
-    _gain_cache_delta() { }
+    _gain_cache_delta(),
+    _large_he_local_pin_counts(),
+    _adjacent_blocks_delta(gain_cache._k) {
+    _adjacent_blocks_delta.setConnectivitySet(&_gain_cache._adjacent_blocks);
+  }
 
   // ####################### Initialize & Reset #######################
 
   void initialize(const size_t size) {
+    _adjacent_blocks_delta.setNumberOfBlocks(_gain_cache._k);
     _gain_cache_delta.initialize(size);
+    _large_he_local_pin_counts.initialize(size);
   }
 
   void clear() {
     _gain_cache_delta.clear();
+    _large_he_local_pin_counts.clear();
+    _adjacent_blocks_delta.reset();
   }
 
   void dropMemory() {
     _gain_cache_delta.freeInternalData();
+    _large_he_local_pin_counts.freeInternalData();
+    _adjacent_blocks_delta.freeInternalData();
   }
 
   size_t size_in_bytes() const {
-    return _gain_cache_delta.size_in_bytes();
+    return _gain_cache_delta.size_in_bytes() +
+      _large_he_local_pin_counts.size_in_bytes() +
+      _adjacent_blocks_delta.size_in_bytes();
   }
 
   // ####################### Gain Computation #######################
 
   // ! Returns an iterator over the adjacent blocks of a node
   IteratorRange<AdjacentBlocksIterator> adjacentBlocks(const HypernodeID hn) const {
+    if ( _gain_cache._track_adjacent_blocks ) {
+      return _adjacent_blocks_delta.connectivitySet(hn);
+    }
     return _gain_cache.adjacentBlocks(hn);
   }
 
@@ -378,7 +715,11 @@ class DeltaKm1GainCache {
                               const PartitionID from) const {
     const HyperedgeWeight* penalty_delta =
       _gain_cache_delta.get_if_contained(_gain_cache.penalty_index(u));
-    return _gain_cache.penaltyTerm(u, from) + ( penalty_delta ? *penalty_delta : 0 );
+    return _gain_cache._gain_cache[_gain_cache.penalty_index(u)].load(std::memory_order_relaxed) +
+      ( penalty_delta ? *penalty_delta : 0 ) +
+      _gain_cache.penaltyTermOfLargeHyperedges(u, from, [&](const size_t large_he, const PartitionID block) {
+        return largeHyperedgePinCount(large_he, block);
+      });
   }
 
   // ! Returns the benefit term for moving node u to block to.
@@ -388,7 +729,11 @@ class DeltaKm1GainCache {
     ASSERT(to != kInvalidPartition && to < _gain_cache._k);
     const HyperedgeWeight* benefit_delta =
       _gain_cache_delta.get_if_contained(_gain_cache.benefit_index(u, to));
-    return _gain_cache.benefitTerm(u, to) + ( benefit_delta ? *benefit_delta : 0 );
+    return _gain_cache.cachedBenefitTerm(u, to) +
+      ( benefit_delta ? *benefit_delta : 0 ) +
+      _gain_cache.benefitTermOfLargeHyperedges(u, to, [&](const size_t large_he, const PartitionID block) {
+        return largeHyperedgePinCount(large_he, block);
+      });
   }
 
   // ! Returns the gain of moving node u from its current block to a target block V_j.
@@ -412,6 +757,16 @@ class DeltaKm1GainCache {
     const HyperedgeWeight edge_weight = sync_update.edge_weight;
     const HypernodeID pin_count_in_from_part_after = sync_update.pin_count_in_from_part_after;
     const HypernodeID pin_count_in_to_part_after = sync_update.pin_count_in_to_part_after;
+    if ( _gain_cache.isLargeHyperedge(sync_update.edge_size) ) {
+      // The delta partition is thread-local, so its pin count updates arrive in order
+      const size_t large_he = _gain_cache.largeHyperedgeIndex(he);
+      _large_he_local_pin_counts[_gain_cache.large_pin_count_index(large_he, from)] =
+        std::min(pin_count_in_from_part_after, ID(2));
+      _large_he_local_pin_counts[_gain_cache.large_pin_count_index(large_he, to)] =
+        std::min(pin_count_in_to_part_after, ID(2));
+      return;
+    }
+
     if (pin_count_in_from_part_after == 1) {
       for (HypernodeID u : partitioned_hg.pins(he)) {
         if (partitioned_hg.partID(u) == from) {
@@ -420,13 +775,13 @@ class DeltaKm1GainCache {
       }
     } else if (pin_count_in_from_part_after == 0) {
       for (HypernodeID u : partitioned_hg.pins(he)) {
-        _gain_cache_delta[_gain_cache.benefit_index(u, from)] -= edge_weight;
+        updateBenefit(u, from, -edge_weight);
       }
     }
 
     if (pin_count_in_to_part_after == 1) {
       for (HypernodeID u : partitioned_hg.pins(he)) {
-        _gain_cache_delta[_gain_cache.benefit_index(u, to)] += edge_weight;
+        updateBenefit(u, to, edge_weight);
       }
     } else if (pin_count_in_to_part_after == 2) {
       for (HypernodeID u : partitioned_hg.pins(he)) {
@@ -446,11 +801,44 @@ class DeltaKm1GainCache {
   }
 
  private:
+  // ! Adds delta to the thread-local benefit term of node u for block to.
+  // ! If the benefit term changes from or to zero, we update the thread-local
+  // ! adjacent blocks of u.
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  void updateBenefit(const HypernodeID u, const PartitionID to, const HyperedgeWeight delta) {
+    HyperedgeWeight& benefit_delta = _gain_cache_delta[_gain_cache.benefit_index(u, to)];
+    benefit_delta += delta;
+    if ( _gain_cache._track_adjacent_blocks && delta != 0 ) {
+      const HyperedgeWeight benefit_after = _gain_cache.cachedBenefitTerm(u, to) + benefit_delta;
+      const HyperedgeWeight benefit_before = benefit_after - delta;
+      if ( benefit_before == 0 ) {
+        _adjacent_blocks_delta.add(u, to);
+      } else if ( benefit_after == 0 ) {
+        _adjacent_blocks_delta.remove(u, to);
+      }
+    }
+  }
+
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  HypernodeID largeHyperedgePinCount(const size_t large_he, const PartitionID block) const {
+    const size_t idx = _gain_cache.large_pin_count_index(large_he, block);
+    const HypernodeID* local_pin_count = _large_he_local_pin_counts.get_if_contained(idx);
+    return local_pin_count ? *local_pin_count :
+      _gain_cache._large_he_pin_counts[idx].load(std::memory_order_relaxed);
+  }
+
   const Km1GainCache& _gain_cache;
 
   // ! Stores the delta of each locally touched gain cache entry
   // ! relative to the gain cache in '_phg'
   ds::DynamicFlatMap<size_t, HyperedgeWeight> _gain_cache_delta;
+
+  // ! Stores the (capped) pin counts of all locally touched large nets
+  ds::DynamicFlatMap<size_t, HypernodeID> _large_he_local_pin_counts;
+
+  // ! Stores the adjacent blocks of a node relative to the gain cache in '_phg'
+  // ! (only used if the gain cache tracks adjacent blocks)
+  ds::DeltaConnectivitySet<ds::ConnectivitySets> _adjacent_blocks_delta;
 };
 
 }  // namespace mt_kahypar
@@ -56,13 +56,20 @@ class Km1GainComputation : public GainComputationBase<Km1GainComputation, Km1Att
                        const HypernodeID hn,
                        RatingMap& tmp_scores,
                        Gain& isolated_block_gain,
-                       const bool) {
+                       const bool consider_non_adjacent_blocks) {
     ASSERT(tmp_scores.size() == 0, "Rating map not empty");
     PartitionID from = phg.partID(hn);
+    bool has_deferred_hyperedges = false;
     for (const HyperedgeID& he : phg.incidentEdges(hn)) {
       HypernodeID pin_count_in_from_part = phg.pinCountInPart(he, from);
       HyperedgeWeight he_weight = phg.edgeWeight(he);
 
+      if ( isDeferred(phg, he, pin_count_in_from_part, consider_non_adjacent_blocks) ) {
+        isolated_block_gain += he_weight;
+        has_deferred_hyperedges = true;
+        continue;
+      }
+
       // In case, there is more one than one pin left in from part, we would
       // increase the connectivity, if we would move the pin to one block
       // no contained in the connectivity set. In such cases, we can only
@@ -82,6 +89,24 @@ class Km1GainComputation : public GainComputationBase<Km1GainComputation, Km1Att
         }
       }
     }
+
+    if ( has_deferred_hyperedges ) {
+      // A hyperedge with more than one pin in the from block only contributes to the gain of
+      // the blocks contained in its connectivity set. Moving the node to a block that is only
+      // adjacent via such hyperedges can not improve the objective. Thus, it is sufficient to
+      // check the blocks that are adjacent via the other hyperedges, which avoids scanning
+      // the (potentially large) connectivity sets of large hyperedges.
+      for (const HyperedgeID& he : phg.incidentEdges(hn)) {
+        if ( isDeferred(phg, he, phg.pinCountInPart(he, from), consider_non_adjacent_blocks) ) {
+          const HyperedgeWeight he_weight = phg.edgeWeight(he);
+          for ( auto& entry : tmp_scores ) {
+            if ( phg.pinCountInPart(he, entry.key) > 0 ) {
+              entry.value += he_weight;
+            }
+          }
+        }
+      }
+    }
   }
 
   HyperedgeWeight gain(const Gain to_score,
@@ -93,6 +118,16 @@ class Km1GainComputation : public GainComputationBase<Km1GainComputation, Km1Att
     // Do nothing
   }
 
+ private:
+  template<typename PartitionedHypergraph>
+  bool isDeferred(const PartitionedHypergraph& phg,
+                  const HyperedgeID he,
+                  const HypernodeID pin_count_in_from_part,
+                  const bool consider_non_adjacent_blocks) const {
+    return !consider_non_adjacent_blocks && pin_count_in_from_part > 1 &&
+      phg.edgeSize(he) > this->_he_size_gain_threshold;
+  }
+
 };
 
 }  // namespace mt_kahypar
@@ -122,6 +122,11 @@ class SteinerTreeGainCache {
     return _is_initialized;
   }
 
+  // ! Returns whether the partitioned (hyper)graph has to call notifyBeforeDeltaGainUpdate(...)
+  bool requiresNotificationBeforeUpdate() const {
+    return true;
+  }
+
   void reset(const bool run_parallel = true) {
     unused(run_parallel);
     _is_initialized = false;
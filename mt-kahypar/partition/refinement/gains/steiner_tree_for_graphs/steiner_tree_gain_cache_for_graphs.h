@@ -138,6 +138,11 @@ class GraphSteinerTreeGainCache {
     return _is_initialized;
   }
 
+  // ! Returns whether the partitioned (hyper)graph has to call notifyBeforeDeltaGainUpdate(...)
+  bool requiresNotificationBeforeUpdate() const {
+    return true;
+  }
+
   void reset(const bool run_parallel = true) {
     unused(run_parallel);
     _is_initialized = false;
@@ -0,0 +1,296 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+#include "mt-kahypar/partition/refinement/jet/jet_refiner.h"
+
+#include <cmath>
+
+#include "tbb/parallel_for.h"
+#include "tbb/enumerable_thread_specific.h"
+
+#include "mt-kahypar/definitions.h"
+#include "mt-kahypar/partition/metrics.h"
+#include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
+#include "mt-kahypar/utils/utilities.h"
+#include "mt-kahypar/utils/timer.h"
+#include "mt-kahypar/utils/cast.h"
+
+namespace mt_kahypar {
+
+  template <typename GraphAndGainTypes>
+  bool JetRefiner<GraphAndGainTypes>::refineImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph,
+                                                 const vec<HypernodeID>& refinement_nodes,
+                                                 Metrics& best_metrics,
+                                                 const double) {
+    PartitionedHypergraph& phg = utils::cast<PartitionedHypergraph>(hypergraph);
+    resizeDataStructuresForCurrentK();
+    utils::Timer& timer = utils::Utilities::instance().getTimer(_context.utility_id);
+    const HyperedgeWeight input_quality = best_metrics.quality;
+    Metrics current_metrics = best_metrics;
+    bool best_is_balanced = metrics::isBalanced(phg, _context);
+    _moved_since_best.reset();
+    _moved_nodes.clear_sequential();
+    // Nodes moved in the last iteration of a previous call are not locked
+    _round += 2;
+
+    size_t iterations_without_improvement = 0;
+    while ( iterations_without_improvement < _context.refinement.jet.num_iterations ) {
+      ++_round;
+      timer.start_timer("jet_compute_moves", "Compute Moves");
+      computeCandidateMoves(phg, refinement_nodes);
+      computeAfterburnerGains(phg, refinement_nodes);
+      timer.stop_timer("jet_compute_moves");
+
+      timer.start_timer("jet_apply_moves", "Apply Moves");
+      const auto [delta, num_moves] = applyMoves(phg, refinement_nodes);
+      current_metrics.quality += delta;
+      timer.stop_timer("jet_apply_moves");
+      if ( num_moves == 0 ) {
+        // No node is locked in the next iteration, which therefore would not find any moves either
+        break;
+      }
+
+      if ( !metrics::isBalanced(phg, _context) ) {
+        rebalance(phg, current_metrics);
+      } else {
+        current_metrics.imbalance = metrics::imbalance(phg, _context);
+      }
+      DBG << "[Jet] Iteration" << _round << ":" << V(num_moves) << V(delta)
+          << V(current_metrics.quality) << V(current_metrics.imbalance);
+
+      if ( metrics::isBalanced(phg, _context) &&
+           ( !best_is_balanced || current_metrics.quality < best_metrics.quality ) ) {
+        const bool significant_improvement = !best_is_balanced ||
+          current_metrics.quality < (1.0 - _context.refinement.jet.relative_improvement_threshold) * best_metrics.quality;
+        iterations_without_improvement = significant_improvement ? 0 : iterations_without_improvement + 1;
+        best_metrics = current_metrics;
+        best_is_balanced = true;
+        // The current partition is the new best partition
+        _moved_since_best.reset();
+        _moved_nodes.clear_parallel();
+      } else {
+        ++iterations_without_improvement;
+      }
+    }
+
+    timer.start_timer("jet_rollback", "Rollback");
+    rollbackToBestPartition(phg);
+    forEachNode(phg, refinement_nodes, [&](const HypernodeID hn) {
+      _target[hn] = kInvalidPartition;
+    });
+    timer.stop_timer("jet_rollback");
+
+    HEAVY_REFINEMENT_ASSERT(phg.checkTrackedPartitionInformation(_gain_cache));
+    HEAVY_REFINEMENT_ASSERT(best_metrics.quality == metrics::quality(phg, _context),
+      V(best_metrics.quality) << V(metrics::quality(phg, _context)));
+
+    const Gain improvement = input_quality - best_metrics.quality;
+    utils::Utilities::instance().getStats(_context.utility_id).update_stat("jet_improvement", improvement);
+    return improvement > 0;
+  }
+
+  template <typename GraphAndGainTypes>
+  void JetRefiner<GraphAndGainTypes>::computeCandidateMoves(PartitionedHypergraph& phg,
+                                                            const vec<HypernodeID>& refinement_nodes) {
+    const double negative_gain_factor = _context.refinement.jet.negative_gain_factor;
+    forEachNode(phg, refinement_nodes, [&](const HypernodeID hn) {
+      _target[hn] = kInvalidPartition;
+      if ( phg.isBorderNode(hn) && !phg.isFixed(hn) && _locked_in_round[hn] != _round - 1 ) {
+        const PartitionID from = phg.partID(hn);
+        PartitionID to = kInvalidPartition;
+        HyperedgeWeight to_benefit = std::numeric_limits<HyperedgeWeight>::min();
+        HypernodeWeight to_weight = std::numeric_limits<HypernodeWeight>::max();
+        // The balance constraint is ignored here and restored by the rebalancer
+        for ( const PartitionID& i : _gain_cache.adjacentBlocks(hn) ) {
+          if ( i != from ) {
+            const HyperedgeWeight benefit = _gain_cache.benefitTerm(hn, i);
+            const HypernodeWeight weight = phg.partWeight(i);
+            if ( benefit > to_benefit || ( benefit == to_benefit && weight < to_weight ) ) {
+              to = i;
+              to_benefit = benefit;
+              to_weight = weight;
+            }
+          }
+        }
+
+        if ( to != kInvalidPartition ) {
+          const HyperedgeWeight penalty = _gain_cache.penaltyTerm(hn, from);
+          const Gain gain = to_benefit - penalty;
+          // Moves with a negative gain are candidates if the loss is small compared
+          // to the connectivity of the node to its current block
+          if ( gain > 0 || -gain < std::floor(negative_gain_factor * penalty) ) {
+            _target[hn] = to;
+            _gain[hn] = gain;
+          }
+        }
+      }
+    });
+  }
+
+  template <typename GraphAndGainTypes>
+  void JetRefiner<GraphAndGainTypes>::computeAfterburnerGains(PartitionedHypergraph& phg,
+                                                              const vec<HypernodeID>& refinement_nodes) {
+    // The afterburner evaluates the connectivity of each incident hyperedge after all
+    // candidates with a higher priority moved. For graphs, this is the exact cut gain.
+    // For other objectives, it is only used to filter the candidates and the real
+    // change of the objective function is tracked via the attributed gains.
+    const size_t he_size_threshold = _context.refinement.jet.afterburner_he_size_threshold;
+    forEachNode(phg, refinement_nodes, [&](const HypernodeID hn) {
+      const PartitionID to = _target[hn];
+      if ( to != kInvalidPartition ) {
+        const PartitionID from = phg.partID(hn);
+        Gain gain = 0;
+        for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+          HypernodeID pins_in_from = 0;
+          HypernodeID pins_in_to = 0;
+          if ( phg.edgeSize(he) <= he_size_threshold ) {
+            for ( const HypernodeID& pin : phg.pins(he) ) {
+              if ( pin != hn ) {
+                const PartitionID block = hasHigherPriority(pin, hn) ? _target[pin] : phg.partID(pin);
+                pins_in_from += ( block == from );
+                pins_in_to += ( block == to );
+              }
+            }
+          } else {
+            // For large hyperedges, we ignore the moves of the other candidates
+            pins_in_from = phg.pinCountInPart(he, from) - 1;
+            pins_in_to = phg.pinCountInPart(he, to);
+          }
+
+          const HyperedgeWeight edge_weight = phg.edgeWeight(he);
+          if ( pins_in_from == 0 ) {
+            gain += edge_weight;
+          }
+          if ( pins_in_to == 0 ) {
+            gain -= edge_weight;
+          }
+        }
+        _afterburner_gain[hn] = gain;
+      }
+    });
+  }
+
+  template <typename GraphAndGainTypes>
+  std::pair<Gain, size_t> JetRefiner<GraphAndGainTypes>::applyMoves(PartitionedHypergraph& phg,
+                                                                    const vec<HypernodeID>& refinement_nodes) {
+    tbb::enumerable_thread_specific<Gain> ets_delta(0);
+    tbb::enumerable_thread_specific<size_t> ets_num_moves(0);
+    forEachNode(phg, refinement_nodes, [&](const HypernodeID hn) {
+      const PartitionID to = _target[hn];
+      if ( to != kInvalidPartition && _afterburner_gain[hn] >= 0 ) {
+        Gain& local_delta = ets_delta.local();
+        auto objective_delta = [&](const SynchronizedEdgeUpdate& sync_update) {
+          local_delta += AttributedGains::gain(sync_update);
+        };
+        const PartitionID from = phg.partID(hn);
+        if ( phg.changeNodePart(_gain_cache, hn, from, to,
+              std::numeric_limits<HypernodeWeight>::max(), []{}, objective_delta) ) {
+          _locked_in_round[hn] = _round;
+          recordMove(hn, from);
+          ++ets_num_moves.local();
+        }
+      }
+    });
+
+    if constexpr ( GainCache::invalidates_entries ) {
+      forEachNode(phg, refinement_nodes, [&](const HypernodeID hn) {
+        if ( _locked_in_round[hn] == _round ) {
+          _gain_cache.recomputeInvalidTerms(phg, hn);
+        }
+      });
+    }
+    return std::make_pair(ets_delta.combine(std::plus<>()),
+                          ets_num_moves.combine(std::plus<>()));
+  }
+
+  template <typename GraphAndGainTypes>
+  void JetRefiner<GraphAndGainTypes>::rebalance(PartitionedHypergraph& phg,
+                                                Metrics& current_metrics) {
+    utils::Timer& timer = utils::Utilities::instance().getTimer(_context.utility_id);
+    timer.start_timer("rebalance_jet", "Rebalance");
+    mt_kahypar_partitioned_hypergraph_t hypergraph = utils::partitioned_hg_cast(phg);
+    _rebalancer.refineAndOutputMovesLinear(hypergraph, {}, _rebalance_moves, current_metrics, 0.0);
+
+    // The rebalancer might move a node several times. Thus, we process the moves
+    // sequentially such that we store the block of a node before its first move.
+    for ( const Move& m : _rebalance_moves ) {
+      recordMove(m.node, m.from);
+      if constexpr ( GainCache::invalidates_entries ) {
+        _gain_cache.recomputeInvalidTerms(phg, m.node);
+      }
+    }
+    timer.stop_timer("rebalance_jet");
+  }
+
+  template <typename GraphAndGainTypes>
+  void JetRefiner<GraphAndGainTypes>::rollbackToBestPartition(PartitionedHypergraph& phg) {
+    const vec<HypernodeID> moved_nodes = _moved_nodes.copy_parallel();
+    auto noop_obj_fn = [](const SynchronizedEdgeUpdate&) { };
+    tbb::parallel_for(UL(0), moved_nodes.size(), [&](const size_t i) {
+      const HypernodeID hn = moved_nodes[i];
+      const PartitionID from = phg.partID(hn);
+      if ( from != _best_part[hn] ) {
+        phg.changeNodePart(_gain_cache, hn, from, _best_part[hn],
+          std::numeric_limits<HypernodeWeight>::max(), []{}, noop_obj_fn);
+      }
+    });
+
+    if constexpr ( GainCache::invalidates_entries ) {
+      tbb::parallel_for(UL(0), moved_nodes.size(), [&](const size_t i) {
+        _gain_cache.recomputeInvalidTerms(phg, moved_nodes[i]);
+      });
+    }
+    _moved_since_best.reset();
+    _moved_nodes.clear_parallel();
+  }
+
+  template <typename GraphAndGainTypes>
+  template<typename F>
+  void JetRefiner<GraphAndGainTypes>::forEachNode(PartitionedHypergraph& phg,
+                                                  const vec<HypernodeID>& refinement_nodes,
+                                                  const F& node_fn) {
+    if ( refinement_nodes.empty() ) {
+      phg.doParallelForAllNodes(node_fn);
+    } else {
+      tbb::parallel_for(UL(0), refinement_nodes.size(), [&](const size_t i) {
+        node_fn(refinement_nodes[i]);
+      });
+    }
+  }
+
+  template <typename GraphAndGainTypes>
+  void JetRefiner<GraphAndGainTypes>::initializeImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph) {
+    PartitionedHypergraph& phg = utils::cast<PartitionedHypergraph>(hypergraph);
+    if ( !_gain_cache.isInitialized() ) {
+      _gain_cache.initializeGainCache(phg);
+    }
+  }
+
+  namespace {
+  #define JET_REFINER(X) JetRefiner<X>
+  }
+
+  // explicitly instantiate so the compiler can generate them when compiling this cpp file
+  INSTANTIATE_CLASS_WITH_VALID_TRAITS(JET_REFINER)
+}
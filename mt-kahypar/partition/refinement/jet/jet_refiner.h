@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include <utility>
+
+#include "mt-kahypar/datastructures/streaming_vector.h"
+#include "mt-kahypar/datastructures/thread_safe_fast_reset_flag_array.h"
+#include "mt-kahypar/parallel/stl/scalable_vector.h"
+#include "mt-kahypar/partition/context.h"
+#include "mt-kahypar/partition/refinement/i_refiner.h"
+#include "mt-kahypar/partition/refinement/i_rebalancer.h"
+#include "mt-kahypar/partition/refinement/gains/gain_cache_ptr.h"
+
+namespace mt_kahypar {
+
+/**
+ * Parallel unconstrained refinement in the spirit of Jet (Gilbert et al., 2024).
+ * Each iteration
+ *  (1) computes the best move of all unlocked border nodes in parallel using the gain cache
+ *      and keeps moves with a bounded negative gain as candidates,
+ *  (2) filters the candidates with an afterburner that recomputes the gain of each candidate
+ *      under the assumption that all candidates with a higher priority (higher gain) already moved,
+ *  (3) applies the remaining moves in bulk without respecting the balance constraint and
+ *  (4) restores the balance constraint with the rebalancer.
+ * The refiner tracks the best balanced partition seen so far and reverts to it at the end.
+ */
+template <typename GraphAndGainTypes>
+class JetRefiner final : public IRefiner {
+ private:
+  using PartitionedHypergraph = typename GraphAndGainTypes::PartitionedHypergraph;
+  using GainCache = typename GraphAndGainTypes::GainCache;
+  using AttributedGains = typename GraphAndGainTypes::AttributedGains;
+
+  static constexpr bool debug = false;
+
+ public:
+  explicit JetRefiner(const HypernodeID num_hypernodes,
+                      const HyperedgeID num_hyperedges,
+                      const Context& context,
+                      GainCache& gain_cache,
+                      IRebalancer& rb) :
+    _context(context),
+    _gain_cache(gain_cache),
+    _current_k(context.partition.k),
+    _round(0),
+    _target(num_hypernodes, kInvalidPartition),
+    _gain(num_hypernodes, 0),
+    _afterburner_gain(num_hypernodes, 0),
+    _locked_in_round(num_hypernodes, 0),
+    _best_part(num_hypernodes, kInvalidPartition),
+    _moved_since_best(num_hypernodes),
+    _moved_nodes(),
+    _rebalance_moves(),
+    _rebalancer(rb) {
+    unused(num_hyperedges);
+  }
+
+  explicit JetRefiner(const HypernodeID num_hypernodes,
+                      const HyperedgeID num_hyperedges,
+                      const Context& context,
+                      gain_cache_t gain_cache,
+                      IRebalancer& rb) :
+    JetRefiner(num_hypernodes, num_hyperedges, context,
+      GainCachePtr::cast<GainCache>(gain_cache), rb) { }
+
+  JetRefiner(const JetRefiner&) = delete;
+  JetRefiner(JetRefiner&&) = delete;
+
+  JetRefiner & operator= (const JetRefiner &) = delete;
+  JetRefiner & operator= (JetRefiner &&) = delete;
+
+ private:
+  bool refineImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph,
+                  const parallel::scalable_vector<HypernodeID>& refinement_nodes,
+                  Metrics& best_metrics,
+                  double) final ;
+
+  void initializeImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph) final;
+
+  // ! Computes the best move of each unlocked border node and stores it
+  // ! if its gain is not below the negative gain tolerance
+  void computeCandidateMoves(PartitionedHypergraph& phg,
+                             const parallel::scalable_vector<HypernodeID>& refinement_nodes);
+
+  // ! Recomputes the gain of each candidate assuming that all candidates
+  // ! with a higher priority are already moved to their target block
+  void computeAfterburnerGains(PartitionedHypergraph& phg,
+                               const parallel::scalable_vector<HypernodeID>& refinement_nodes);
+
+  // ! Applies all candidates with a non-negative afterburner gain and returns
+  // ! the change of the objective function and the number of moved nodes
+  std::pair<Gain, size_t> applyMoves(PartitionedHypergraph& phg,
+                                     const parallel::scalable_vector<HypernodeID>& refinement_nodes);
+
+  // ! Restores the balance constraint and records the moves of the rebalancer
+  void rebalance(PartitionedHypergraph& phg, Metrics& current_metrics);
+
+  // ! Reverts all nodes moved since the last best partition
+  void rollbackToBestPartition(PartitionedHypergraph& phg);
+
+  void recordMove(const HypernodeID hn, const PartitionID from) {
+    if ( _moved_since_best.compare_and_set_to_true(hn) ) {
+      _best_part[hn] = from;
+      _moved_nodes.stream(hn);
+    }
+  }
+
+  // ! A candidate u has a higher priority than a candidate v if its gain is
+  // ! larger or if the gains are equal and the ID of u is smaller.
+  bool hasHigherPriority(const HypernodeID u, const HypernodeID v) const {
+    return _target[u] != kInvalidPartition &&
+      ( _gain[u] > _gain[v] || ( _gain[u] == _gain[v] && u < v ) );
+  }
+
+  template<typename F>
+  void forEachNode(PartitionedHypergraph& phg,
+                   const parallel::scalable_vector<HypernodeID>& refinement_nodes,
+                   const F& node_fn);
+
+  void resizeDataStructuresForCurrentK() {
+    // If the number of blocks changes, we resize data structures
+    // (can happen during deep multilevel partitioning)
+    if ( _current_k != _context.partition.k ) {
+      _current_k = _context.partition.k;
+      if ( _gain_cache.isInitialized() ) {
+        _gain_cache.changeNumberOfBlocks(_current_k);
+      }
+    }
+  }
+
+  const Context& _context;
+  GainCache& _gain_cache;
+  PartitionID _current_k;
+  uint32_t _round;
+  parallel::scalable_vector<PartitionID> _target;
+  parallel::scalable_vector<Gain> _gain;
+  parallel::scalable_vector<Gain> _afterburner_gain;
+  parallel::scalable_vector<uint32_t> _locked_in_round;
+  parallel::scalable_vector<PartitionID> _best_part;
+  ds::ThreadSafeFastResetFlagArray<> _moved_since_best;
+  ds::StreamingVector<HypernodeID> _moved_nodes;
+  parallel::scalable_vector<Move> _rebalance_moves;
+  IRebalancer& _rebalancer;
+};
+
+}  // namespace mt_kahypar
@@ -31,6 +31,7 @@
 
 #include "mt-kahypar/definitions.h"
 #include "mt-kahypar/partition/metrics.h"
+#include "mt-kahypar/parallel/parallel_counting_sort.h"
 #include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
 #include "mt-kahypar/utils/randomize.h"
 #include "mt-kahypar/utils/utilities.h"
@@ -227,24 +228,64 @@ namespace mt_kahypar {
     if ( _context.refinement.label_propagation.execute_sequential ) {
       utils::Randomize::instance().shuffleVector(
               _active_nodes, UL(0), _active_nodes.size(), THREAD_ID);
-
-      for ( size_t j = 0; j < _active_nodes.size(); ++j ) {
-        const HypernodeID hn = _active_nodes[j];
-        if ( moveVertex<unconstrained>(phg, hn, next_active_nodes, objective_delta) ) {
-          if (should_mark_nodes) { _active_node_was_moved[j] = uint8_t(true); }
-        }
-      }
     } else {
       utils::Randomize::instance().parallelShuffleVector(
               _active_nodes, UL(0), _active_nodes.size());
+    }
 
-      tbb::parallel_for(UL(0), _active_nodes.size(), [&](const size_t& j) {
-        const HypernodeID hn = _active_nodes[j];
-        if ( moveVertex<unconstrained>(phg, hn, next_active_nodes, objective_delta) ) {
-          if (should_mark_nodes) { _active_node_was_moved[j] = uint8_t(true); }
+    // bucket_bounds[i] stores the first position of the i-th bucket of active nodes
+    vec<uint32_t> bucket_bounds;
+    if ( _context.refinement.label_propagation.use_gain_buckets && _gain_cache.isInitialized() ) {
+      const size_t num_active_nodes = _active_nodes.size();
+      bucket_bounds = sortActiveNodesIntoGainBuckets(phg);
+      utils::Stats& stats = utils::Utilities::instance().getStats(_context.utility_id);
+      stats.update_stat("lp_processed_nodes", static_cast<int64_t>(_active_nodes.size()));
+      stats.update_stat("lp_skipped_nodes", static_cast<int64_t>(num_active_nodes - _active_nodes.size()));
+      DBG << "[LP] Processed nodes:" << _active_nodes.size() << "Skipped nodes:" << (num_active_nodes - _active_nodes.size());
+    } else {
+      bucket_bounds = { 0, static_cast<uint32_t>(_active_nodes.size()) };
+    }
+
+    for ( size_t b = 0; b + 1 < bucket_bounds.size(); ++b ) {
+      if ( _context.refinement.label_propagation.execute_sequential ) {
+        for ( size_t j = bucket_bounds[b]; j < bucket_bounds[b + 1]; ++j ) {
+          const HypernodeID hn = _active_nodes[j];
+          if ( moveVertex<unconstrained>(phg, hn, next_active_nodes, objective_delta) ) {
+            if (should_mark_nodes) { _active_node_was_moved[j] = uint8_t(true); }
+          }
         }
-      });
+      } else {
+        tbb::parallel_for(UL(bucket_bounds[b]), UL(bucket_bounds[b + 1]), [&](const size_t& j) {
+          const HypernodeID hn = _active_nodes[j];
+          if ( moveVertex<unconstrained>(phg, hn, next_active_nodes, objective_delta) ) {
+            if (should_mark_nodes) { _active_node_was_moved[j] = uint8_t(true); }
+          }
+        });
+      }
+    }
+  }
+
+  template <typename GraphAndGainTypes>
+  vec<uint32_t> LabelPropagationRefiner<GraphAndGainTypes>::sortActiveNodesIntoGainBuckets(const PartitionedHypergraph& hypergraph) {
+    // The counting sort is stable, which preserves the random order of the nodes within a bucket
+    auto get_bucket = [&](const HypernodeID hn) { return gainBucket(hypergraph, hn); };
+    ActiveNodes sorted_active_nodes(_active_nodes.size());
+    vec<uint32_t> bucket_bounds = parallel::counting_sort(_active_nodes, sorted_active_nodes,
+      SKIP_BUCKET + 1, get_bucket, _context.refinement.label_propagation.execute_sequential ?
+        UL(1) : _context.shared_memory.num_threads);
+    _active_nodes = std::move(sorted_active_nodes);
+
+    // Nodes that cannot improve the solution are not processed. If one of their neighbors
+    // is moved, they are reactivated in the next round. If the gain cache excludes large nets
+    // (see r-gain-cache-large-he-threshold), the buckets are not exact enough to rule out
+    // an improvement and we process these nodes last instead.
+    const bool excludes_large_hyperedges = !_context.isNLevelPartitioning() &&
+      _context.refinement.gain_cache_large_he_threshold != std::numeric_limits<HypernodeID>::max();
+    if ( !excludes_large_hyperedges ) {
+      _active_nodes.resize(bucket_bounds[SKIP_BUCKET]);
+      bucket_bounds.resize(SKIP_BUCKET + 1);
     }
+    return bucket_bounds;
   }
 
 
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <cmath>
+
 #include "kahypar-resources/datastructure/fast_reset_flag_array.h"
 
 #include "mt-kahypar/datastructures/streaming_vector.h"
@@ -53,6 +55,13 @@ class LabelPropagationRefiner final : public IRefiner {
   static constexpr bool debug = false;
   static constexpr bool enable_heavy_assert = false;
 
+  // Gain buckets of the active nodes (see r-lp-use-gain-buckets). Positive gains are
+  // bucketed by their logarithm, followed by the zero gain bucket and the bucket of nodes
+  // that cannot improve the solution (which are not processed).
+  static constexpr size_t NUM_POSITIVE_GAIN_BUCKETS = 16;
+  static constexpr size_t ZERO_GAIN_BUCKET = NUM_POSITIVE_GAIN_BUCKETS;
+  static constexpr size_t SKIP_BUCKET = NUM_POSITIVE_GAIN_BUCKETS + 1;
+
  public:
   explicit LabelPropagationRefiner(const HypernodeID num_hypernodes,
                                    const HyperedgeID num_hyperedges,
@@ -73,7 +82,10 @@ class LabelPropagationRefiner final : public IRefiner {
     _old_part_is_initialized(_context.refinement.label_propagation.unconstrained ? num_hypernodes : 0),
     _next_active(num_hypernodes),
     _visited_he(Hypergraph::is_graph ? 0 : num_hyperedges),
-    _rebalancer(rb) { }
+    _rebalancer(rb) {
+    _gain.setHyperedgeSizeGainThreshold(
+      _context.refinement.label_propagation.hyperedge_size_gain_threshold);
+  }
 
   explicit LabelPropagationRefiner(const HypernodeID num_hypernodes,
                                    const HyperedgeID num_hyperedges,
@@ -123,6 +135,8 @@ class LabelPropagationRefiner final : public IRefiner {
   void initializeActiveNodes(PartitionedHypergraph& hypergraph,
                              const parallel::scalable_vector<HypernodeID>& refinement_nodes);
 
+  vec<uint32_t> sortActiveNodesIntoGainBuckets(const PartitionedHypergraph& hypergraph);
+
   void initializeImpl(mt_kahypar_partitioned_hypergraph_t&) final;
 
   template<bool unconstrained, typename F>
@@ -183,6 +197,35 @@ class LabelPropagationRefiner final : public IRefiner {
     }
   }
 
+  // ! Returns the gain bucket of a node based on its best move in the gain cache (ignoring balance)
+  MT_KAHYPAR_ATTRIBUTE_ALWAYS_INLINE
+  size_t gainBucket(const PartitionedHypergraph& hypergraph, const HypernodeID hn) const {
+    if ( hypergraph.isFixed(hn) || !hypergraph.isBorderNode(hn) ) {
+      return SKIP_BUCKET;
+    }
+    const PartitionID from = hypergraph.partID(hn);
+    HyperedgeWeight best_benefit = std::numeric_limits<HyperedgeWeight>::min();
+    for ( const PartitionID& to : _gain_cache.adjacentBlocks(hn) ) {
+      if ( to != from ) {
+        best_benefit = std::max(best_benefit, _gain_cache.benefitTerm(hn, to));
+      }
+    }
+    if ( best_benefit == std::numeric_limits<HyperedgeWeight>::min() ) {
+      return SKIP_BUCKET;
+    }
+
+    const Gain gain = best_benefit - _gain_cache.penaltyTerm(hn, from);
+    if ( gain > 0 ) {
+      const size_t log_gain = std::min(NUM_POSITIVE_GAIN_BUCKETS - 1,
+        static_cast<size_t>(std::log2(static_cast<double>(gain))));
+      return NUM_POSITIVE_GAIN_BUCKETS - 1 - log_gain;
+    } else if ( gain == 0 && _context.refinement.label_propagation.rebalancing ) {
+      // zero gain moves are only performed if they improve balance
+      return ZERO_GAIN_BUCKET;
+    }
+    return SKIP_BUCKET;
+  }
+
   void resizeDataStructuresForCurrentK() {
     // If the number of blocks changes, we resize data structures
     // (can happen during deep multilevel partitioning)
@@ -26,11 +26,14 @@
 
 #include "mt-kahypar/partition/refinement/rebalancing/advanced_rebalancer.h"
 
+#include <algorithm>
 #include <array>
 #include <optional>
+#include <tuple>
 
 #include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
 #include "mt-kahypar/utils/cast.h"
+#include "mt-kahypar/utils/utilities.h"
 #include "mt-kahypar/partition/context.h"
 
 #include "pcg_random.hpp"
@@ -52,14 +55,14 @@ namespace impl {
   template<typename PartitionedHypergraph, typename GainCache>
   std::pair<PartitionID, float> computeBestTargetBlock(
           const PartitionedHypergraph& phg, const Context& context, const GainCache& gain_cache,
-          HypernodeID u, PartitionID from) {
+          HypernodeID u, PartitionID from, const rebalancer::TransportPlan* plan = nullptr) {
     const HypernodeWeight wu = phg.nodeWeight(u);
     const HypernodeWeight from_weight = phg.partWeight(from);
     PartitionID to = kInvalidPartition;
     HyperedgeWeight to_benefit = std::numeric_limits<HyperedgeWeight>::min();
     HypernodeWeight best_to_weight = from_weight - wu;
     for (PartitionID i = 0; i < context.partition.k; ++i) {
-      if (i != from) {
+      if (i != from && (plan == nullptr || plan->allows(from, i))) {
         const HypernodeWeight to_weight = phg.partWeight(i);
         const HyperedgeWeight benefit = gain_cache.benefitTerm(u, i);
         if ((benefit > to_benefit || (benefit == to_benefit && to_weight < best_to_weight)) &&
@@ -71,6 +74,11 @@ namespace impl {
       }
     }
 
+    if (to == kInvalidPartition && plan != nullptr && plan->isEnabled()) {
+      // the node does not fit into any block with a remaining budget in the plan
+      return computeBestTargetBlock(phg, context, gain_cache, u, from, nullptr);
+    }
+
     Gain gain = std::numeric_limits<Gain>::min();
     if (to != kInvalidPartition) {
       gain = to_benefit - gain_cache.penaltyTerm(u, phg.partID(u));
@@ -81,14 +89,15 @@ namespace impl {
   template<typename PartitionedHypergraph, typename GainCache>
   std::pair<PartitionID, float> bestOfThree(
           const PartitionedHypergraph& phg, const Context& context, const GainCache& gain_cache,
-          HypernodeID u, PartitionID from, std::array<PartitionID, 3> parts) {
+          HypernodeID u, PartitionID from, std::array<PartitionID, 3> parts,
+          const rebalancer::TransportPlan* plan = nullptr) {
     const HypernodeWeight wu = phg.nodeWeight(u);
     const HypernodeWeight from_weight = phg.partWeight(from);
     PartitionID to = kInvalidPartition;
     HyperedgeWeight to_benefit = std::numeric_limits<HyperedgeWeight>::min();
     HypernodeWeight best_to_weight = from_weight - wu;
     for (PartitionID i : parts) {
-      if (i != from && i != kInvalidPartition) {
+      if (i != from && i != kInvalidPartition && (plan == nullptr || plan->allows(from, i))) {
         const HypernodeWeight to_weight = phg.partWeight(i);
         const HyperedgeWeight benefit = gain_cache.benefitTerm(u, i);
         if ((benefit > to_benefit || (benefit == to_benefit && to_weight < best_to_weight)) &&
@@ -105,8 +114,34 @@ namespace impl {
       return std::make_pair(to, transformGain(gain, wu));
     } else {
       // edge case: if u does not fit in any of the three considered blocks we need to check all blocks
-      return computeBestTargetBlock(phg, context, gain_cache, u, from);
+      return computeBestTargetBlock(phg, context, gain_cache, u, from, plan);
+    }
+  }
+
+  // ! Best fit for heavy nodes: the block whose remaining capacity is smallest
+  // ! after inserting u, ties broken by benefit.
+  template<typename PartitionedHypergraph, typename GainCache>
+  PartitionID computeTightestFitBlock(
+          const PartitionedHypergraph& phg, const Context& context, const GainCache& gain_cache,
+          HypernodeID u, PartitionID from) {
+    const HypernodeWeight wu = phg.nodeWeight(u);
+    PartitionID to = kInvalidPartition;
+    HypernodeWeight best_residual = std::numeric_limits<HypernodeWeight>::max();
+    HyperedgeWeight to_benefit = std::numeric_limits<HyperedgeWeight>::min();
+    for (PartitionID i = 0; i < context.partition.k; ++i) {
+      if (i != from) {
+        const HypernodeWeight residual = context.partition.max_part_weights[i] - phg.partWeight(i) - wu;
+        if (residual >= 0 && residual <= best_residual) {
+          const HyperedgeWeight benefit = gain_cache.benefitTerm(u, i);
+          if (residual < best_residual || benefit > to_benefit) {
+            best_residual = residual;
+            to_benefit = benefit;
+            to = i;
+          }
+        }
+      }
     }
+    return to;
   }
 
   struct AccessToken {
@@ -135,13 +170,20 @@ namespace impl {
     vec<rebalancer::GuardedPQ>& _pqs;
     ds::Array<PartitionID>& _target_part;
     ds::Array<rebalancer::NodeState>& _node_state;
+    const rebalancer::TransportPlan& _plan;
     AccessToken _token;
+    // ! Moves extracted from a PQ under the same lock acquisition as next_move
+    vec<Move> _batch;
+    size_t _batch_pos = 0;
+    size_t num_batched_moves = 0;
 
     NextMoveFinder(int seed, const Context& context, PartitionedHypergraph& phg, GainCache& gain_cache,
                    vec<rebalancer::GuardedPQ>& pqs,
-                   ds::Array<PartitionID>& target_part, ds::Array<rebalancer::NodeState>& node_state) :
+                   ds::Array<PartitionID>& target_part, ds::Array<rebalancer::NodeState>& node_state,
+                   const rebalancer::TransportPlan& plan) :
                    _phg(phg), _gain_cache(gain_cache), _context(context),
-                   _pqs(pqs), _target_part(target_part), _node_state(node_state), _token(seed, pqs.size()) { }
+                   _pqs(pqs), _target_part(target_part), _node_state(node_state), _plan(plan),
+                   _token(seed, pqs.size()) { }
 
 
     void recomputeTopGainMove(HypernodeID v, const Move& move /* of the neighbor */) {
@@ -149,17 +191,17 @@ namespace impl {
       PartitionID newTarget = kInvalidPartition;
       const PartitionID designatedTargetV = _target_part[v];
       if (_context.partition.k < 4 || designatedTargetV == move.from || designatedTargetV == move.to) {
-        std::tie(newTarget, gain) = computeBestTargetBlock(_phg, _context, _gain_cache, v, _phg.partID(v));
+        std::tie(newTarget, gain) = computeBestTargetBlock(_phg, _context, _gain_cache, v, _phg.partID(v), &_plan);
       } else {
         std::tie(newTarget, gain) = bestOfThree(_phg, _context, _gain_cache,
-                                                v, _phg.partID(v), {designatedTargetV, move.from, move.to});
+                                                v, _phg.partID(v), {designatedTargetV, move.from, move.to}, &_plan);
       }
       _target_part[v] = newTarget;
     }
 
     bool checkCandidate(HypernodeID u, float& gain_in_pq) {
       if (!_node_state[u].tryLock()) return false;
-      auto [to, true_gain] = computeBestTargetBlock(_phg, _context, _gain_cache, u, _phg.partID(u));
+      auto [to, true_gain] = computeBestTargetBlock(_phg, _context, _gain_cache, u, _phg.partID(u), &_plan);
       if (true_gain >= gain_in_pq) {
         next_move.node = u;
         next_move.to = to;
@@ -175,28 +217,67 @@ namespace impl {
     }
 
     bool lockedModifyPQ(size_t best_id) {
+      // The PQs of a heavily overloaded block contain many nodes. In this case, we extract
+      // a small batch of moves under a single lock acquisition to reduce contention on the PQ locks.
+      static constexpr size_t MAX_BATCH_SIZE = 16;
+      static constexpr size_t MIN_PQ_SIZE_PER_BATCH_ELEMENT = 64;
       auto& gpq = _pqs[best_id];
       auto& pq = gpq.pq;
 
-      HypernodeID node = pq.top();
-      float gain_in_pq = pq.topKey();
-      const bool success = checkCandidate(node, gain_in_pq);
-
-      if (success) {
-        pq.deleteTop();
-        gpq.top_key = pq.empty() ? std::numeric_limits<float>::min() : pq.topKey();
-      } else {
-        // gain was updated by success_func in this case
-        if (_target_part[node] != kInvalidPartition) {
-          pq.adjustKey(node, gain_in_pq);
-          gpq.top_key = pq.topKey();
-        } else {
+      const size_t batch_size = std::clamp(
+        static_cast<size_t>(pq.size()) / MIN_PQ_SIZE_PER_BATCH_ELEMENT, size_t(1), MAX_BATCH_SIZE);
+      size_t num_extracted = 0;
+      Move first_move;
+      while (num_extracted < batch_size && !pq.empty()) {
+        HypernodeID node = pq.top();
+        float gain_in_pq = pq.topKey();
+        if (checkCandidate(node, gain_in_pq)) {
           pq.deleteTop();
-          gpq.top_key = pq.empty() ? std::numeric_limits<float>::min() : pq.topKey();
+          if (num_extracted == 0) {
+            first_move = next_move;
+          } else {
+            _batch.push_back(next_move);
+            ++num_batched_moves;
+          }
+          ++num_extracted;
+        } else {
+          // gain was updated by success_func in this case
+          if (_target_part[node] != kInvalidPartition) {
+            pq.adjustKey(node, gain_in_pq);
+          } else {
+            pq.deleteTop();
+          }
+          break;
         }
       }
+      gpq.top_key = pq.empty() ? std::numeric_limits<float>::min() : pq.topKey();
       gpq.lock.unlock();
-      return success;
+
+      if (num_extracted > 0) {
+        next_move = first_move;
+      }
+      return num_extracted > 0;
+    }
+
+    bool popFromBatch() {
+      while (_batch_pos < _batch.size()) {
+        const HypernodeID u = _batch[_batch_pos++].node;
+        // the node is locked while it is in the batch, which means that gain updates of
+        // moved neighbors were not applied to it => recompute its best target block
+        const PartitionID from = _phg.partID(u);
+        auto [to, gain] = computeBestTargetBlock(_phg, _context, _gain_cache, u, from, &_plan);
+        if (to != kInvalidPartition) {
+          next_move.node = u;
+          next_move.to = to;
+          next_move.from = from;
+          next_move.gain = gain;
+          return true;
+        }
+        _node_state[u].unlock();
+      }
+      _batch.clear();
+      _batch_pos = 0;
+      return false;
     }
 
     bool tryPop() {
@@ -241,7 +322,7 @@ namespace impl {
     }
 
     bool findNextMove() {
-      return tryPop();
+      return popFromBatch() || tryPop();
     }
   };
 
@@ -256,6 +337,80 @@ namespace impl {
 
 } // namespace impl
 
+namespace rebalancer {
+
+  void TransportPlan::initialize(const vec<PartitionID>& overloaded_blocks, const PartitionID k, const bool enable) {
+    const size_t num_entries = overloaded_blocks.size() * static_cast<size_t>(k);
+    _enabled = enable && !overloaded_blocks.empty() && num_entries <= MAX_NUM_ENTRIES;
+    if (_enabled) {
+      _k = k;
+      _overloaded_index.assign(k, -1);
+      for (size_t i = 0; i < overloaded_blocks.size(); ++i) {
+        _overloaded_index[overloaded_blocks[i]] = i;
+      }
+      _remaining.assign(num_entries, CAtomic<HypernodeWeight>(0));
+    }
+  }
+
+  void TransportPlan::compute(vec<HypernodeWeight> excess, vec<HypernodeWeight> slack) {
+    ASSERT(_enabled);
+    const size_t num_overloaded_blocks = excess.size();
+    vec<HypernodeWeight> planned(_remaining.size(), 0);
+    auto transport = [&](const size_t i, const PartitionID to, const HypernodeWeight max_amount) {
+      const HypernodeWeight amount = std::min({ max_amount, excess[i], slack[to] });
+      if (amount > 0) {
+        planned[i * _k + to] += amount;
+        excess[i] -= amount;
+        slack[to] -= amount;
+      }
+    };
+
+    // (1) send weight along the block pairs with the highest affinity
+    struct Affinity {
+      HypernodeWeight weight;
+      size_t from;
+      PartitionID to;
+    };
+    vec<Affinity> affinities;
+    for (size_t i = 0; i < num_overloaded_blocks; ++i) {
+      for (PartitionID to = 0; to < _k; ++to) {
+        const HypernodeWeight weight = _remaining[i * _k + to].load(std::memory_order_relaxed);
+        if (weight > 0 && slack[to] > 0) {
+          affinities.push_back(Affinity { weight, i, to });
+        }
+      }
+    }
+    std::sort(affinities.begin(), affinities.end(), [](const Affinity& lhs, const Affinity& rhs) {
+      return lhs.weight > rhs.weight || (lhs.weight == rhs.weight &&
+        (lhs.from < rhs.from || (lhs.from == rhs.from && lhs.to < rhs.to)));
+    });
+    for (const Affinity& affinity : affinities) {
+      transport(affinity.from, affinity.to, affinity.weight);
+    }
+
+    // (2) distribute the remaining excess weight to the blocks with the most slack
+    vec<PartitionID> targets;
+    for (PartitionID to = 0; to < _k; ++to) {
+      if (slack[to] > 0) targets.push_back(to);
+    }
+    std::sort(targets.begin(), targets.end(), [&](const PartitionID lhs, const PartitionID rhs) {
+      return slack[lhs] > slack[rhs] || (slack[lhs] == slack[rhs] && lhs < rhs);
+    });
+    size_t pos = 0;
+    for (size_t i = 0; i < num_overloaded_blocks; ++i) {
+      while (excess[i] > 0 && pos < targets.size()) {
+        transport(i, targets[pos], excess[i]);
+        if (slack[targets[pos]] == 0) ++pos;
+      }
+    }
+
+    for (size_t j = 0; j < _remaining.size(); ++j) {
+      _remaining[j].store(planned[j], std::memory_order_relaxed);
+    }
+  }
+
+} // namespace rebalancer
+
 
   template <typename GraphAndGainTypes>
   void AdvancedRebalancer<GraphAndGainTypes>::insertNodesInOverloadedBlocks(mt_kahypar_partitioned_hypergraph_t& hypergraph) {
@@ -286,6 +441,7 @@ namespace impl {
 
       _node_state[u].markAsMovable();
       _target_part[u] = target;
+      _plan.addAffinity(b, target, phg.nodeWeight(u));
 
       auto& token = ets_tokens.local();
       int my_pq_id = -1;
@@ -309,10 +465,74 @@ namespace impl {
   }
 
   template <typename GraphAndGainTypes>
-  std::pair<int64_t, size_t> AdvancedRebalancer<GraphAndGainTypes>::findMoves(mt_kahypar_partitioned_hypergraph_t& hypergraph) {
+  std::pair<int64_t, size_t> AdvancedRebalancer<GraphAndGainTypes>::moveHeavyNodes(mt_kahypar_partitioned_hypergraph_t& hypergraph) {
+    auto& phg = utils::cast<PartitionedHypergraph>(hypergraph);
+    const size_t num_heavy_nodes = _context.refinement.rebalancer_num_heavy_nodes;
+    auto heavier = [&](const HypernodeID lhs, const HypernodeID rhs) {
+      const HypernodeWeight w_lhs = phg.nodeWeight(lhs);
+      const HypernodeWeight w_rhs = phg.nodeWeight(rhs);
+      return w_lhs > w_rhs || (w_lhs == w_rhs && lhs < rhs);
+    };
+
+    // each thread keeps the heaviest nodes it has seen in a min-heap (w.r.t. weight)
+    tbb::enumerable_thread_specific<vec<HypernodeID>> ets_heavy_nodes;
+    phg.doParallelForAllNodes([&](HypernodeID u) {
+      if (!_is_overloaded[phg.partID(u)] || phg.isFixed(u)) return;
+      vec<HypernodeID>& heap = ets_heavy_nodes.local();
+      if (heap.size() < num_heavy_nodes) {
+        heap.push_back(u);
+        std::push_heap(heap.begin(), heap.end(), heavier);
+      } else if (heavier(u, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), heavier);
+        heap.back() = u;
+        std::push_heap(heap.begin(), heap.end(), heavier);
+      }
+    });
+
+    vec<HypernodeID> heavy_nodes;
+    for (const vec<HypernodeID>& heap : ets_heavy_nodes) {
+      heavy_nodes.insert(heavy_nodes.end(), heap.begin(), heap.end());
+    }
+    std::sort(heavy_nodes.begin(), heavy_nodes.end(), heavier);
+    heavy_nodes.resize(std::min(heavy_nodes.size(), num_heavy_nodes));
+
+    // Decreasing-size assignment: a heavy node only leaves its block if it does not overshoot the
+    // remaining excess, and it goes to the block it fills up most tightly. Thus, the heavy nodes cannot
+    // overload their target blocks and the remaining excess is left to the light nodes.
+    int64_t attributed_gain = 0;
+    size_t num_moves = 0;
+    for (const HypernodeID u : heavy_nodes) {
+      const PartitionID from = phg.partID(u);
+      const HypernodeWeight wu = phg.nodeWeight(u);
+      const HypernodeWeight excess = phg.partWeight(from) - _context.partition.max_part_weights[from];
+      if (excess <= 0 || wu > excess) continue;
+
+      const PartitionID to = impl::computeTightestFitBlock(phg, _context, _gain_cache, u, from);
+      if (to == kInvalidPartition) continue;
+
+      Gain delta = 0;
+      const bool moved = phg.changeNodePart(
+                    _gain_cache, u, from, to, _context.partition.max_part_weights[to], [] { },
+                    [&](const SynchronizedEdgeUpdate& sync_update) {
+                      delta += AttributedGains::gain(sync_update);
+                    });
+      if (moved) {
+        attributed_gain += delta;
+        _moves[num_moves++] = Move { from, to, u, -delta };
+      }
+    }
+
+    utils::Utilities::instance().getStats(_context.utility_id).update_stat(
+            "rebalancer_heavy_node_moves", static_cast<int64_t>(num_moves));
+    return std::make_pair(attributed_gain, num_moves);
+  }
+
+  template <typename GraphAndGainTypes>
+  std::pair<int64_t, size_t> AdvancedRebalancer<GraphAndGainTypes>::findMoves(mt_kahypar_partitioned_hypergraph_t& hypergraph,
+                                                                              const size_t first_move_id) {
     auto& phg = utils::cast<PartitionedHypergraph>(hypergraph);
     int64_t attributed_gain = 0;
-    size_t global_move_id = 0;
+    size_t global_move_id = first_move_id;
     size_t num_overloaded_blocks = _overloaded_blocks.size();
 
     auto task = [&](size_t task_id) {
@@ -323,7 +543,7 @@ namespace impl {
 
       const int seed = phg.initialNumNodes() + task_id;
 
-      impl::NextMoveFinder next_move_finder(seed, _context, phg, _gain_cache, _pqs, _target_part, _node_state);
+      impl::NextMoveFinder next_move_finder(seed, _context, phg, _gain_cache, _pqs, _target_part, _node_state, _plan);
 
       while (num_overloaded_blocks > 0 && next_move_finder.findNextMove()) {
         const Move& m = next_move_finder.next_move;
@@ -352,6 +572,7 @@ namespace impl {
 
 
         if (!moved) continue;
+        _plan.consume(m.from, m.to, phg.nodeWeight(m.node));
 
         auto update_neighbor = [&](HypernodeID v) {
           if (v != m.node && _node_state[v].tryLock()) {
@@ -411,6 +632,8 @@ namespace impl {
         _moves[move_id] = m;
       }
       __atomic_fetch_add(&attributed_gain, local_attributed_gain, __ATOMIC_RELAXED);
+      utils::Utilities::instance().getStats(_context.utility_id).update_stat(
+              "rebalancer_batched_moves", static_cast<int64_t>(next_move_finder.num_batched_moves));
     };
 
     tbb::task_group tg;
@@ -436,9 +659,41 @@ namespace impl {
       }
     }
 
+    size_t num_heavy_node_moves = 0;
+    int64_t heavy_node_gain = 0;
+    if (_context.refinement.rebalancer_num_heavy_nodes > 0 && !_overloaded_blocks.empty()) {
+      std::tie(heavy_node_gain, num_heavy_node_moves) = moveHeavyNodes(hypergraph);
+      _overloaded_blocks.clear();
+      for (PartitionID k = 0; k < _context.partition.k; ++k) {
+        _is_overloaded[k] = phg.partWeight(k) > _context.partition.max_part_weights[k];
+        if (_is_overloaded[k]) {
+          _overloaded_blocks.push_back(k);
+        }
+      }
+    }
+
+    _plan.initialize(_overloaded_blocks, _context.partition.k, _context.refinement.rebalancer_use_transport_plan);
     insertNodesInOverloadedBlocks(hypergraph);
+    if (_plan.isEnabled()) {
+      vec<HypernodeWeight> excess;
+      vec<HypernodeWeight> slack(_context.partition.k, 0);
+      for (PartitionID b = 0; b < _context.partition.k; ++b) {
+        if (_is_overloaded[b]) {
+          excess.push_back(phg.partWeight(b) - _context.partition.max_part_weights[b]);
+        } else {
+          slack[b] = std::max(0, _context.partition.max_part_weights[b] - phg.partWeight(b));
+        }
+      }
+      _plan.compute(std::move(excess), std::move(slack));
+    }
 
-    auto [attributed_gain, num_moves_performed] = findMoves(hypergraph);
+    HighResClockTimepoint start = std::chrono::high_resolution_clock::now();
+    auto [attributed_gain, num_moves_performed] = findMoves(hypergraph, num_heavy_node_moves);
+    attributed_gain += heavy_node_gain;
+    HighResClockTimepoint end = std::chrono::high_resolution_clock::now();
+    const double elapsed_time = std::chrono::duration<double>(end - start).count();
+    DBG << "Rebalancing performed" << num_moves_performed << "moves in" << elapsed_time
+        << "s (" << (elapsed_time > 0 ? num_moves_performed / elapsed_time : 0.0) << "moves/s )";
 
     if (moves_by_part != nullptr) {
       moves_by_part->resize(_context.partition.k);
@@ -27,6 +27,7 @@
 #pragma once
 
 #include "mt-kahypar/datastructures/priority_queue.h"
+#include "mt-kahypar/parallel/atomic_wrapper.h"
 #include "mt-kahypar/partition/context.h"
 #include "mt-kahypar/partition/metrics.h"
 #include "mt-kahypar/partition/refinement/i_refiner.h"
@@ -71,6 +72,61 @@ namespace rebalancer {
     void reset() { state = 0; }
   };
 
+  // Global plan that determines how much weight each overloaded block sends to which block
+  // (see r-rebalancer-use-transport-plan). During rebalancing, nodes of an overloaded block
+  // are only moved to blocks with a remaining budget in the plan.
+  class TransportPlan {
+    static constexpr size_t MAX_NUM_ENTRIES = UL(1) << 24;
+
+   public:
+    // ! Enables the plan for the given overloaded blocks (if the plan is not too large)
+    void initialize(const vec<PartitionID>& overloaded_blocks, const PartitionID k, const bool enable);
+
+    // ! Affinity of an overloaded block to a target block is the weight of the nodes whose
+    // ! best target is that block
+    void addAffinity(const PartitionID from, const PartitionID to, const HypernodeWeight weight) {
+      if ( _enabled ) {
+        _remaining[index(from, to)].fetch_add(weight, std::memory_order_relaxed);
+      }
+    }
+
+    // ! Computes the plan from the excess weight of the overloaded blocks
+    // ! (in order of overloaded_blocks) and the slack of all blocks
+    void compute(vec<HypernodeWeight> excess, vec<HypernodeWeight> slack);
+
+    bool isEnabled() const {
+      return _enabled;
+    }
+
+    bool allows(const PartitionID from, const PartitionID to) const {
+      return !_enabled || _overloaded_index[from] == -1 ||
+        _remaining[index(from, to)].load(std::memory_order_relaxed) > 0;
+    }
+
+    void consume(const PartitionID from, const PartitionID to, const HypernodeWeight weight) {
+      if ( _enabled && _overloaded_index[from] != -1 ) {
+        _remaining[index(from, to)].fetch_sub(weight, std::memory_order_relaxed);
+      }
+    }
+
+    // ! Budget that the overloaded block from has left for moves to block to
+    HypernodeWeight remainingBudget(const PartitionID from, const PartitionID to) const {
+      return _remaining[index(from, to)].load(std::memory_order_relaxed);
+    }
+
+   private:
+    size_t index(const PartitionID from, const PartitionID to) const {
+      ASSERT(_overloaded_index[from] != -1);
+      return static_cast<size_t>(_overloaded_index[from]) * _k + to;
+    }
+
+    bool _enabled = false;
+    PartitionID _k = 0;
+    vec<int> _overloaded_index;
+    // ! Affinities before compute(...), remaining budget of each block pair afterwards
+    vec<CAtomic<HypernodeWeight>> _remaining;
+  };
+
 } // namespace rebalancer
 
 
@@ -95,6 +151,10 @@ public:
                         const Context& context,
                         gain_cache_t gain_cache);
 
+  const rebalancer::TransportPlan& transportPlan() const {
+    return _plan;
+  }
+
 private:
   bool refineImpl(mt_kahypar_partitioned_hypergraph_t& hypergraph,
                   const vec<HypernodeID>& refinement_nodes,
@@ -127,7 +187,8 @@ private:
 
 
   void insertNodesInOverloadedBlocks(mt_kahypar_partitioned_hypergraph_t& hypergraph);
-  std::pair<int64_t, size_t> findMoves(mt_kahypar_partitioned_hypergraph_t& hypergraph);
+  std::pair<int64_t, size_t> moveHeavyNodes(mt_kahypar_partitioned_hypergraph_t& hypergraph);
+  std::pair<int64_t, size_t> findMoves(mt_kahypar_partitioned_hypergraph_t& hypergraph, const size_t first_move_id);
 
   ds::Array<Move> _moves;
   vec<rebalancer::GuardedPQ> _pqs;
@@ -137,6 +198,7 @@ private:
   ds::Array<PosT> _pq_handles;
   ds::Array<int> _pq_id;
   ds::Array<rebalancer::NodeState> _node_state;
+  rebalancer::TransportPlan _plan;
 };
 
 }  // namespace mt_kahypar
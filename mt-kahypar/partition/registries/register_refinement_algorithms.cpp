@@ -35,6 +35,8 @@
 #include "mt-kahypar/partition/refinement/do_nothing_refiner.h"
 #include "mt-kahypar/partition/refinement/label_propagation/label_propagation_refiner.h"
 #include "mt-kahypar/partition/refinement/deterministic/deterministic_label_propagation.h"
+#include "mt-kahypar/partition/refinement/deterministic/deterministic_fm.h"
+#include "mt-kahypar/partition/refinement/jet/jet_refiner.h"
 #include "mt-kahypar/partition/refinement/fm/multitry_kway_fm.h"
 #include "mt-kahypar/partition/refinement/fm/strategies/gain_cache_strategy.h"
 #include "mt-kahypar/partition/refinement/fm/strategies/unconstrained_strategy.h"
@@ -57,6 +59,11 @@ using DeterministicLabelPropagationDispatcher = kahypar::meta::StaticMultiDispat
                                                 IRefiner,
                                                 kahypar::meta::Typelist<GraphAndGainTypesList>>;
 
+using JetDispatcher = kahypar::meta::StaticMultiDispatchFactory<
+                      JetRefiner,
+                      IRefiner,
+                      kahypar::meta::Typelist<GraphAndGainTypesList>>;
+
 using DefaultFMDispatcher = kahypar::meta::StaticMultiDispatchFactory<
                             MultiTryKWayFM,
                             IRefiner,
@@ -64,6 +71,11 @@ using DefaultFMDispatcher = kahypar::meta::StaticMultiDispatchFactory<
 
 using UnconstrainedFMDispatcher = DefaultFMDispatcher;
 
+using DeterministicFMDispatcher = kahypar::meta::StaticMultiDispatchFactory<
+                                  DeterministicFMRefiner,
+                                  IRefiner,
+                                  kahypar::meta::Typelist<GraphAndGainTypesList>>;
+
 using GainCacheFMStrategyDispatcher = kahypar::meta::StaticMultiDispatchFactory<
                                       GainCacheStrategy,
                                       IFMStrategy,
@@ -218,6 +230,9 @@ REGISTER_DISPATCHED_LP_REFINER(LabelPropagationAlgorithm::label_propagation,
 REGISTER_DISPATCHED_LP_REFINER(LabelPropagationAlgorithm::deterministic,
                                DeterministicLabelPropagationDispatcher,
                                getGraphAndGainTypesPolicy(context.partition.partition_type, context.partition.gain_policy));
+REGISTER_DISPATCHED_LP_REFINER(LabelPropagationAlgorithm::jet,
+                               JetDispatcher,
+                               getGraphAndGainTypesPolicy(context.partition.partition_type, context.partition.gain_policy));
 REGISTER_LP_REFINER(LabelPropagationAlgorithm::do_nothing, DoNothingRefiner, 1);
 
 REGISTER_DISPATCHED_FM_REFINER(FMAlgorithm::kway_fm,
@@ -226,6 +241,9 @@ REGISTER_DISPATCHED_FM_REFINER(FMAlgorithm::kway_fm,
 REGISTER_DISPATCHED_FM_REFINER(FMAlgorithm::unconstrained_fm,
                                UnconstrainedFMDispatcher,
                                getGraphAndGainTypesPolicy(context.partition.partition_type, context.partition.gain_policy));
+REGISTER_DISPATCHED_FM_REFINER(FMAlgorithm::deterministic_fm,
+                               DeterministicFMDispatcher,
+                               getGraphAndGainTypesPolicy(context.partition.partition_type, context.partition.gain_policy));
 REGISTER_FM_REFINER(FMAlgorithm::do_nothing, DoNothingRefiner, 3);
 
 REGISTER_DISPATCHED_FM_STRATEGY(FMAlgorithm::kway_fm,
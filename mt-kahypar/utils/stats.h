@@ -112,6 +112,10 @@ class Stats {
       _value_5 += delta;
     }
 
+    int64_t int64Value() const {
+      return _value_3;
+    }
+
     friend std::ostream & operator<< (std::ostream& str, const Stat& stat);
 
    private:
@@ -180,6 +184,13 @@ class Stats {
     }
   }
 
+  // ! Returns the value of an integer stat (zero, if the stat does not exist)
+  int64_t get_int64_stat(const std::string& key) {
+    std::lock_guard<std::mutex> lock(_stat_mutex);
+    auto it = _stats.find(key);
+    return it != _stats.end() ? it->second.int64Value() : 0;
+  }
+
   void clear() {
     _stats.clear();
   }
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+#include "gmock/gmock.h"
+
+#include "tbb/parallel_for.h"
+
+#include "mt-kahypar/datastructures/chunked_vector.h"
+
+using ::testing::Test;
+
+namespace mt_kahypar {
+namespace ds {
+
+using TestVector = ChunkedVector<int, 4>;
+
+TEST(AChunkedVector, DoesNotAllocateMemoryOnConstruction) {
+  TestVector vec(100);
+  ASSERT_EQ(100, vec.size());
+  for ( size_t i = 0; i < vec.size(); ++i ) {
+    ASSERT_FALSE(vec.isAllocated(i));
+  }
+  ASSERT_EQ(7 * sizeof(std::atomic<int*>), vec.size_in_bytes());
+}
+
+TEST(AChunkedVector, AllocatesChunkOnFirstWrite) {
+  TestVector vec(100);
+  vec.set(17, 42);
+  ASSERT_EQ(42, vec[17]);
+  for ( size_t i = 16; i < 32; ++i ) {
+    ASSERT_TRUE(vec.isAllocated(i));
+  }
+  ASSERT_FALSE(vec.isAllocated(15));
+  ASSERT_FALSE(vec.isAllocated(32));
+  ASSERT_EQ(16 * sizeof(int) + 7 * sizeof(std::atomic<int*>), vec.size_in_bytes());
+}
+
+TEST(AChunkedVector, ModifiesEntries) {
+  TestVector vec(20);
+  vec.set(3, 1);
+  vec[3] += 2;
+  ASSERT_EQ(3, vec[3]);
+}
+
+TEST(AChunkedVector, SupportsConcurrentWrites) {
+  const size_t n = 100000;
+  TestVector vec(n);
+  tbb::parallel_for(UL(0), n, [&](const size_t i) {
+    vec.set(i, static_cast<int>(i));
+  });
+  for ( size_t i = 0; i < n; ++i ) {
+    ASSERT_EQ(static_cast<int>(i), vec[i]);
+  }
+  ASSERT_EQ(( n + 15 ) / 16 * ( 16 * sizeof(int) + sizeof(std::atomic<int*>) ), vec.size_in_bytes());
+}
+
+TEST(AChunkedVector, KeepsEntriesOnResize) {
+  TestVector vec(20);
+  vec.set(5, 5);
+  vec.set(18, 18);
+  vec.resize(100);
+  ASSERT_EQ(5, vec[5]);
+  ASSERT_EQ(18, vec[18]);
+  vec.resize(10);
+  ASSERT_EQ(5, vec[5]);
+  ASSERT_EQ(16 * sizeof(int) + sizeof(std::atomic<int*>), vec.size_in_bytes());
+}
+
+TEST(AChunkedVector, SwapsContents) {
+  TestVector vec_1(20);
+  TestVector vec_2(40);
+  vec_1.set(1, 1);
+  vec_2.set(35, 2);
+  vec_1.swap(vec_2);
+  ASSERT_EQ(40, vec_1.size());
+  ASSERT_EQ(20, vec_2.size());
+  ASSERT_EQ(2, vec_1[35]);
+  ASSERT_EQ(1, vec_2[1]);
+}
+
+}  // namespace ds
+}  // namespace mt_kahypar
@@ -115,5 +115,69 @@ TEST(WorkContainer, WorkStealingWorks) {
   ASSERT_EQ(steals + own_pops, m);
 }
 
+TEST(WorkContainer, DistributesElementsToNumaNodes) {
+  WorkContainer<int> cdc(4);
+  cdc.setNumaNodes({ 0, 0, 1, 1 });
+  ASSERT_TRUE(cdc.isNumaAware());
+  for (int i = 0; i < 100; ++i) {
+    cdc.safe_push(i, 0);
+  }
+  cdc.distribute_to_numa_nodes([&](const int el) { return el < 40 ? 0 : 1; });
+  ASSERT_EQ(100, cdc.unsafe_size());
+  ASSERT_EQ(20, cdc.tls_queues[0].elements.size());
+  ASSERT_EQ(20, cdc.tls_queues[1].elements.size());
+  ASSERT_EQ(30, cdc.tls_queues[2].elements.size());
+  ASSERT_EQ(30, cdc.tls_queues[3].elements.size());
+  for (size_t q = 0; q < 4; ++q) {
+    for (const int el : cdc.tls_queues[q].elements) {
+      ASSERT_EQ(q < 2, el < 40);
+    }
+  }
+  ASSERT_EQ(40, cdc.numa_stats[0].assigned.load());
+  ASSERT_EQ(60, cdc.numa_stats[1].assigned.load());
+}
+
+TEST(WorkContainer, SkipsNumaNodesWithoutQueues) {
+  WorkContainer<int> cdc(4);
+  cdc.setNumaNodes({ 0, 0, 2, 2 });
+  ASSERT_TRUE(cdc.isNumaAware());
+  ASSERT_EQ(2, cdc.numNonEmptyNumaNodes());
+  for (int i = 0; i < 100; ++i) {
+    cdc.safe_push(i, 0);
+  }
+  cdc.distribute_to_numa_nodes([&](const int el) { return el < 40 ? 0 : 1; });
+  ASSERT_EQ(100, cdc.unsafe_size());
+  for (size_t q = 0; q < 4; ++q) {
+    for (const int el : cdc.tls_queues[q].elements) {
+      ASSERT_EQ(q < 2, el < 40);
+    }
+  }
+  ASSERT_EQ(40, cdc.numa_stats[0].assigned.load());
+  ASSERT_EQ(0, cdc.numa_stats[1].assigned.load());
+  ASSERT_EQ(60, cdc.numa_stats[2].assigned.load());
+}
+
+TEST(WorkContainer, StealsFromSameNumaNodeFirst) {
+  WorkContainer<int> cdc(4);
+  cdc.setNumaNodes({ 0, 0, 1, 1 });
+  for (int i = 0; i < 100; ++i) {
+    cdc.safe_push(i, 0);
+  }
+  cdc.distribute_to_numa_nodes([&](const int el) { return el < 40 ? 0 : 1; });
+
+  int el = 0;
+  for (int i = 0; i < 40; ++i) {
+    ASSERT_TRUE(cdc.try_pop(el, 0));
+    ASSERT_LT(el, 40);
+  }
+  for (int i = 40; i < 100; ++i) {
+    ASSERT_TRUE(cdc.try_pop(el, 0));
+    ASSERT_GE(el, 40);
+  }
+  ASSERT_FALSE(cdc.try_pop(el, 0));
+  ASSERT_EQ(20, cdc.numa_stats[0].local_steals.load());
+  ASSERT_EQ(60, cdc.numa_stats[0].remote_steals.load());
+}
+
 }  // namespace parallel
 }  // namespace mt_kahypar
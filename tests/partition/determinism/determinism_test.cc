@@ -33,6 +33,8 @@
 #include "mt-kahypar/partition/initial_partitioning/bfs_initial_partitioner.h"
 #include "mt-kahypar/partition/coarsening/deterministic_multilevel_coarsener.h"
 #include "mt-kahypar/partition/refinement/deterministic/deterministic_label_propagation.h"
+#include "mt-kahypar/partition/refinement/deterministic/deterministic_fm.h"
+#include "mt-kahypar/partition/refinement/rebalancing/simple_rebalancer.h"
 #include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
 #include "mt-kahypar/partition/preprocessing/community_detection/parallel_louvain.h"
 #include "mt-kahypar/utils/cast.h"
@@ -148,6 +150,53 @@ public:
     }
   }
 
+  void performRepeatedFMRefinement() {
+    using FMTypes = GraphAndGainTypes<TypeTraits, Km1GainTypes>;
+    context.refinement.fm.algorithm = FMAlgorithm::deterministic_fm;
+    context.refinement.fm.multitry_rounds = 10;
+    context.refinement.fm.num_seed_nodes = 25;
+    context.refinement.fm.rollback_parallel = true;
+    context.refinement.fm.rollback_balance_violation_factor = 1.0;
+    context.refinement.fm.min_improvement = -1.0;
+    context.refinement.deterministic_refinement.num_sub_rounds_fm = 4;
+
+    initialPartition();
+    vec<PartitionID> initial_partition(hypergraph.initialNumNodes());
+    for (HypernodeID u : hypergraph.nodes()) {
+      initial_partition[u] = partitioned_hypergraph.partID(u);
+    }
+
+    vec<PartitionID> first(hypergraph.initialNumNodes());
+    for (size_t i = 0; i < num_repetitions; ++i) {
+      partitioned_hypergraph.resetPartition();
+      for (HypernodeID u : hypergraph.nodes()) {
+        partitioned_hypergraph.setNodePart(u, initial_partition[u]);
+      }
+
+      mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(partitioned_hypergraph);
+      Km1GainCache gain_cache;
+      SimpleRebalancer<FMTypes> rebalancer(context);
+      DeterministicFMRefiner<FMTypes> refiner(
+        hypergraph.initialNumNodes(), hypergraph.initialNumEdges(), context, gain_cache, rebalancer);
+      refiner.initialize(phg);
+      vec<HypernodeID> dummy_refinement_nodes;
+      Metrics my_metrics = metrics;
+      refiner.refine(phg, dummy_refinement_nodes, my_metrics, 0.0);
+      ASSERT_EQ(my_metrics.quality, metrics::quality(partitioned_hypergraph, context));
+      ASSERT_LE(my_metrics.quality, metrics.quality);
+
+      if (i == 0) {
+        for (HypernodeID u : hypergraph.nodes()) {
+          first[u] = partitioned_hypergraph.partID(u);
+        }
+      } else {
+        for (HypernodeID u : hypergraph.nodes()) {
+          ASSERT_EQ(first[u], partitioned_hypergraph.partID(u));
+        }
+      }
+    }
+  }
+
   Hypergraph hypergraph;
   PartitionedHypergraph partitioned_hypergraph;
   Context context;
@@ -237,6 +286,27 @@ TEST_F(DeterminismTest, RefinementK2) {
   performRepeatedRefinement();
 }
 
+TEST_F(DeterminismTest, RefinementLargeK) {
+  // k^2 exceeds the number of moves => moves are aggregated by sorting instead of counting sort
+  context.partition.k = 128;
+  partitioned_hypergraph = PartitionedHypergraph(
+          context.partition.k, hypergraph, parallel_tag_t());
+  context.setupPartWeights(hypergraph.totalWeight());
+  performRepeatedRefinement();
+}
+
+TEST_F(DeterminismTest, FMRefinement) {
+  performRepeatedFMRefinement();
+}
+
+TEST_F(DeterminismTest, FMRefinementK2) {
+  context.partition.k = 2;
+  partitioned_hypergraph = PartitionedHypergraph(
+          context.partition.k, hypergraph, parallel_tag_t());
+  context.setupPartWeights(hypergraph.totalWeight());
+  performRepeatedFMRefinement();
+}
+
 TEST_F(DeterminismTest, RefinementOnCoarseHypergraph) {
   UncoarseningData<TypeTraits> uncoarseningData(false, hypergraph, context);
   uncoarsening_data_t* data_ptr = uncoarsening::to_pointer(uncoarseningData);
@@ -35,6 +35,7 @@
 #include "mt-kahypar/partition/refinement/rebalancing/advanced_rebalancer.h"
 #include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
 #include "mt-kahypar/utils/randomize.h"
+#include "mt-kahypar/utils/utilities.h"
 
 using ::testing::Test;
 
@@ -105,6 +106,35 @@ class RebalancerTest : public Test {
     rebalancer = std::make_unique<Rebalancer>(hypergraph.initialNumNodes(), context, gain_cache);
   }
 
+  // ! Puts all nodes into the first block, rebalances the partition and
+  // ! verifies that the result is balanced. Returns the performed moves.
+  vec<Move> rebalanceFirstBlock() {
+    partitioned_hypergraph.doParallelForAllNodes([&](const HypernodeID hn) {
+      partitioned_hypergraph.setOnlyNodePart(hn, 0);
+    });
+
+    partitioned_hypergraph.initializePartition();
+    mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(partitioned_hypergraph);
+    rebalancer->initialize(phg);
+
+    Metrics metrics;
+    metrics.quality = metrics::quality(partitioned_hypergraph, context);
+    metrics.imbalance = metrics::imbalance(partitioned_hypergraph, context);
+    vec<Move> moves;
+    rebalancer->refineAndOutputMovesLinear(phg, {}, moves, metrics, std::numeric_limits<double>::max());
+
+    EXPECT_EQ(metrics::quality(partitioned_hypergraph, context), metrics.quality);
+    EXPECT_DOUBLE_EQ(metrics::imbalance(partitioned_hypergraph, context), metrics.imbalance);
+    for (PartitionID part = 0; part < context.partition.k; ++part) {
+      EXPECT_LE(partitioned_hypergraph.partWeight(part), context.partition.max_part_weights[part]);
+    }
+    return moves;
+  }
+
+  int64_t stat(const std::string& key) const {
+    return utils::Utilities::instance().getStats(context.utility_id).get_int64_stat(key);
+  }
+
   Hypergraph hypergraph;
   PartitionedHypergraph partitioned_hypergraph;
   Context context;
@@ -170,4 +200,109 @@ TYPED_TEST(RebalancerTest, ProducesBalancedResult) {
   }
 }
 
+TYPED_TEST(RebalancerTest, ExtractsMovesInBatchesFromALargeOverloadedBlock) {
+  this->constructFromFile();
+  // few PQs with many nodes each, such that moves are extracted in batches
+  this->context.shared_memory.num_threads = 2;
+  this->setup();
+
+  const vec<Move> moves = this->rebalanceFirstBlock();
+  ASSERT_FALSE(moves.empty());
+  ASSERT_GT(this->stat("rebalancer_batched_moves"), 0);
+}
+
+TEST(ATransportPlan, SendsExcessWeightAlongAffinitiesFirst) {
+  rebalancer::TransportPlan plan;
+  plan.initialize({ 0 }, 4, true);
+  ASSERT_TRUE(plan.isEnabled());
+  plan.addAffinity(0, 1, 10);
+  plan.addAffinity(0, 2, 3);
+  // block 0 is overloaded by 20, blocks 1, 2 and 3 have a slack of 8, 5 and 30
+  plan.compute({ 20 }, { 0, 8, 5, 30 });
+
+  // The affinities saturate block 1 and send 3 to block 2. The remaining
+  // excess weight of 9 goes to block 3, which has the most slack left.
+  auto verify_budget = [&](const PartitionID to, const HypernodeWeight budget) {
+    if ( budget > 0 ) {
+      ASSERT_TRUE(plan.allows(0, to));
+      plan.consume(0, to, budget - 1);
+      ASSERT_TRUE(plan.allows(0, to));
+      plan.consume(0, to, 1);
+    }
+    ASSERT_FALSE(plan.allows(0, to));
+  };
+  verify_budget(1, 8);
+  verify_budget(2, 3);
+  verify_budget(3, 9);
+
+  // Moves out of blocks that are not overloaded are not restricted
+  ASSERT_TRUE(plan.allows(1, 2));
+}
+
+TEST(ATransportPlan, AllowsAllMovesIfDisabled) {
+  rebalancer::TransportPlan plan;
+  plan.initialize({ 0 }, 4, false);
+  ASSERT_FALSE(plan.isEnabled());
+  plan.consume(0, 1, 100);
+  ASSERT_TRUE(plan.allows(0, 1));
+  ASSERT_TRUE(plan.allows(0, 2));
+}
+
+TYPED_TEST(RebalancerTest, RespectsTheBudgetsOfTheTransportPlanForIndividualPartWeights) {
+  this->constructFromFile();
+  // with a single thread and unit node weights, the budgets are never overdrawn
+  this->context.shared_memory.num_threads = 1;
+  this->context.refinement.rebalancer_use_transport_plan = true;
+  this->context.partition.use_individual_part_weights = true;
+  this->context.partition.max_part_weights.clear();
+  for (PartitionID part = 0; part < this->context.partition.k; ++part) {
+    // very different targets: block i is (i + 1) times larger than block 0
+    const double fraction = (part + 1) / static_cast<double>(
+      this->context.partition.k * (this->context.partition.k + 1) / 2);
+    this->context.partition.max_part_weights.push_back(
+      std::ceil(1.1 * fraction * this->hypergraph.totalWeight()));
+  }
+  this->setup();
+
+  // all nodes are put into the first block, which is the smallest one
+  const HypernodeWeight excess = this->hypergraph.totalWeight() - this->context.partition.max_part_weights[0];
+  const vec<Move> moves = this->rebalanceFirstBlock();
+
+  vec<HypernodeWeight> moved_weight(this->context.partition.k, 0);
+  for (const Move& m : moves) {
+    ASSERT_EQ(0, m.from);
+    moved_weight[m.to] += this->hypergraph.nodeWeight(m.node);
+  }
+  // the plan distributes exactly the excess weight and no budget was exceeded
+  const rebalancer::TransportPlan& plan = this->rebalancer->transportPlan();
+  ASSERT_TRUE(plan.isEnabled());
+  HypernodeWeight planned_weight = 0;
+  for (PartitionID to = 1; to < this->context.partition.k; ++to) {
+    ASSERT_GE(plan.remainingBudget(0, to), 0);
+    planned_weight += moved_weight[to] + plan.remainingBudget(0, to);
+  }
+  ASSERT_EQ(excess, planned_weight);
+}
+
+TYPED_TEST(RebalancerTest, MovesHeavyNodesFirst) {
+  // 8 heavy nodes of weight 8 followed by 64 nodes of weight 1, connected as a path
+  vec<HypernodeWeight> node_weights(72, 1);
+  vec<vec<HypernodeID>> edges;
+  for (HypernodeID hn = 0; hn < 72; ++hn) {
+    if (hn < 8) node_weights[hn] = 8;
+    if (hn + 1 < 72) edges.push_back({hn, hn + 1});
+  }
+  this->constructFromValues(72, edges.size(), edges, node_weights);
+  this->context.refinement.rebalancer_num_heavy_nodes = 4;
+  this->setup();
+
+  // the excess weight of the first block is large enough for all four heavy nodes
+  const vec<Move> moves = this->rebalanceFirstBlock();
+  ASSERT_EQ(4, this->stat("rebalancer_heavy_node_moves"));
+  ASSERT_GE(moves.size(), UL(4));
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(8, this->hypergraph.nodeWeight(moves[i].node));
+  }
+}
+
 }
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+#include "gmock/gmock.h"
+
+#include "mt-kahypar/partition/context.h"
+#include "mt-kahypar/partition/refinement/fm/fm_effort_controller.h"
+
+using ::testing::Test;
+
+namespace mt_kahypar {
+
+class AFMEffortController : public Test {
+ public:
+  AFMEffortController() :
+    context(),
+    controller(context) {
+    context.refinement.fm.multitry_rounds = 10;
+    context.refinement.fm.adaptive_effort = true;
+    context.refinement.fm.adaptive_effort_min_rate_fraction = 0.1;
+    context.refinement.fm.adaptive_effort_min_effort = 0.25;
+  }
+
+  Context context;
+  FMEffortController controller;
+};
+
+TEST_F(AFMEffortController, UsesFullEffortOnFirstLevel) {
+  controller.startLevel(1000);
+  ASSERT_EQ(1.0, controller.effort());
+  ASSERT_EQ(10, controller.maxRounds());
+  ASSERT_EQ(25, controller.numSeedNodes(25));
+  ASSERT_EQ(1.0, controller.stopRuleAlpha());
+}
+
+TEST_F(AFMEffortController, ContinuesIfRateIsCloseToReferenceRate) {
+  controller.startLevel(1000);
+  ASSERT_TRUE(controller.reportRound(100, 1000, 1.0));
+  ASSERT_TRUE(controller.reportRound(50, 900, 1.0));
+}
+
+TEST_F(AFMEffortController, StopsIfRateDropsBelowFractionOfReferenceRate) {
+  controller.startLevel(1000);
+  ASSERT_TRUE(controller.reportRound(100, 1000, 1.0));
+  ASSERT_FALSE(controller.reportRound(1, 900, 1.0));
+}
+
+TEST_F(AFMEffortController, ReducesEffortAfterUnproductiveLevel) {
+  controller.startLevel(1000);
+  controller.reportRound(100, 1000, 1.0);
+  controller.finishLevel(1, false);
+
+  controller.startLevel(1000);
+  controller.reportRound(1, 900, 1.0);
+  controller.finishLevel(1, true);
+
+  controller.startLevel(1000);
+  ASSERT_EQ(0.25, controller.effort());
+  ASSERT_EQ(3, controller.maxRounds());
+  ASSERT_EQ(6, controller.numSeedNodes(25));
+  ASSERT_EQ(0.625, controller.stopRuleAlpha());
+}
+
+TEST_F(AFMEffortController, KeepsFullEffortAfterProductiveLevel) {
+  controller.startLevel(1000);
+  controller.reportRound(100, 1000, 1.0);
+  controller.finishLevel(1, false);
+
+  controller.startLevel(1000);
+  controller.reportRound(200, 900, 1.0);
+  controller.finishLevel(1, false);
+
+  controller.startLevel(1000);
+  ASSERT_EQ(1.0, controller.effort());
+}
+
+TEST_F(AFMEffortController, NormalizesRateByLevelSize) {
+  controller.startLevel(1000);
+  controller.reportRound(100, 1000, 1.0);
+  controller.finishLevel(1, false);
+
+  // ten times larger level that takes ten times longer for the same relative improvement
+  controller.startLevel(10000);
+  ASSERT_TRUE(controller.reportRound(100, 1000, 10.0));
+  controller.finishLevel(1, false);
+
+  controller.startLevel(100000);
+  ASSERT_EQ(1.0, controller.effort());
+}
+
+}  // namespace mt_kahypar
@@ -44,10 +44,20 @@ using ::testing::Test;
 
 namespace mt_kahypar {
 
-template<typename TypeTraitsT, typename GainTypesT>
+// ! Optional features of the km1 gain cache that are enabled in a test configuration
+enum class GainCacheFeature : uint8_t {
+  none,
+  large_hyperedges,
+  lazy_initialization,
+  adjacent_blocks,
+  adjacent_blocks_with_lazy_initialization
+};
+
+template<typename TypeTraitsT, typename GainTypesT, GainCacheFeature feature = GainCacheFeature::none>
 struct TestConfig {
   using TypeTraits = TypeTraitsT;
   using GainTypes = GainTypesT;
+  static constexpr GainCacheFeature FEATURE = feature;
 };
 
 template<typename Config>
@@ -82,6 +92,19 @@ class AGainCache : public Test {
 
     context.partition.k = k;
     context.type = ContextType::main;
+    if constexpr ( Config::FEATURE != GainCacheFeature::none ) {
+      if constexpr ( Config::FEATURE == GainCacheFeature::large_hyperedges ) {
+        context.refinement.gain_cache_large_he_threshold = 4;
+      } else if constexpr ( Config::FEATURE == GainCacheFeature::lazy_initialization ) {
+        context.refinement.lazy_gain_cache_initialization = true;
+      } else if constexpr ( Config::FEATURE == GainCacheFeature::adjacent_blocks ) {
+        context.refinement.gain_cache_track_adjacent_blocks = true;
+      } else if constexpr ( Config::FEATURE == GainCacheFeature::adjacent_blocks_with_lazy_initialization ) {
+        context.refinement.gain_cache_track_adjacent_blocks = true;
+        context.refinement.lazy_gain_cache_initialization = true;
+      }
+      gain_cache = GainCache(context);
+    }
 
     if constexpr ( Hypergraph::is_graph ) {
       hypergraph = io::readInputFile<Hypergraph>(
@@ -364,7 +387,8 @@ class AGainCache : public Test {
 
   bool supportsAdjacentBlocks() const {
     return GainCache::TYPE == GainPolicy::steiner_tree ||
-      GainCache::TYPE == GainPolicy::steiner_tree_for_graphs;
+      GainCache::TYPE == GainPolicy::steiner_tree_for_graphs ||
+      ( GainCache::TYPE == GainPolicy::km1 && context.refinement.gain_cache_track_adjacent_blocks );
   }
 
   void verifyAdjacentBlocks() {
@@ -390,6 +414,19 @@ class AGainCache : public Test {
     }
   }
 
+  // ! A block is adjacent to a node if and only if its benefit term is non-zero
+  void verifyAdjacentBlocksMatchBenefitTerms() {
+    partitioned_hg.doParallelForAllNodes([&](const HypernodeID& hn) {
+      vec<bool> is_adjacent(k, false);
+      for ( const PartitionID& block : gain_cache.adjacentBlocks(hn) ) {
+        is_adjacent[block] = true;
+      }
+      for ( PartitionID block = 0; block < k; ++block ) {
+        EXPECT_EQ(gain_cache.benefitTerm(hn, block) != 0, is_adjacent[block]) << V(hn) << V(block);
+      }
+    });
+  }
+
   void verifyAdjacentBlocksOfDeltaGainCache() {
     if ( supportsAdjacentBlocks() ) {
       for ( const HypernodeID& hn : delta_phg->nodes() ) {
@@ -431,6 +468,10 @@ class AGainCache : public Test {
 };
 
 typedef ::testing::Types<TestConfig<StaticHypergraphTypeTraits, Km1GainTypes>,
+                         TestConfig<StaticHypergraphTypeTraits, Km1GainTypes, GainCacheFeature::large_hyperedges>,
+                         TestConfig<StaticHypergraphTypeTraits, Km1GainTypes, GainCacheFeature::lazy_initialization>,
+                         TestConfig<StaticHypergraphTypeTraits, Km1GainTypes, GainCacheFeature::adjacent_blocks>,
+                         TestConfig<StaticHypergraphTypeTraits, Km1GainTypes, GainCacheFeature::adjacent_blocks_with_lazy_initialization>,
                          TestConfig<StaticHypergraphTypeTraits, CutGainTypes>
                          ENABLE_SOED(COMMA TestConfig<StaticHypergraphTypeTraits COMMA SoedGainTypes>)
                          ENABLE_STEINER_TREE(COMMA TestConfig<StaticHypergraphTypeTraits COMMA SteinerTreeGainTypes>)
@@ -512,4 +553,102 @@ TYPED_TEST(AGainCache, HasCorrectGainsAfterNLevelUncontractionWithLocalizedRefin
 
 #endif
 
+using AKm1GainCacheWithLargeHyperedges =
+  AGainCache<TestConfig<StaticHypergraphTypeTraits, Km1GainTypes, GainCacheFeature::large_hyperedges>>;
+
+TEST_F(AKm1GainCacheWithLargeHyperedges, ExcludesLargeHyperedgesFromCachedTerms) {
+  initializePartition();
+  gain_cache.initializeGainCache(partitioned_hg);
+  ASSERT_GT(gain_cache.numLargeHyperedges(), UL(0));
+
+  moveAllNodesAtRandom();
+  partitioned_hg.doParallelForAllNodes([&](const HypernodeID& hn) {
+    const PartitionID from = partitioned_hg.partID(hn);
+    HyperedgeWeight expected_penalty = 0;
+    vec<HyperedgeWeight> expected_benefit(k, 0);
+    for ( const HyperedgeID& he : partitioned_hg.incidentEdges(hn) ) {
+      if ( partitioned_hg.edgeSize(he) <= context.refinement.gain_cache_large_he_threshold ) {
+        const HyperedgeWeight edge_weight = partitioned_hg.edgeWeight(he);
+        if ( partitioned_hg.pinCountInPart(he, from) > 1 ) {
+          expected_penalty += edge_weight;
+        }
+        for ( const PartitionID& block : partitioned_hg.connectivitySet(he) ) {
+          expected_benefit[block] += edge_weight;
+        }
+      }
+    }
+    ASSERT_EQ(expected_penalty, gain_cache.cachedPenaltyTerm(hn)) << V(hn);
+    for ( PartitionID to = 0; to < k; ++to ) {
+      ASSERT_EQ(expected_benefit[to], gain_cache.cachedBenefitTerm(hn, to)) << V(hn) << V(to);
+    }
+  });
+}
+
+TEST_F(AKm1GainCacheWithLargeHyperedges, HasCorrectGainsAfterResetAndReinitialization) {
+  initializePartition();
+  gain_cache.initializeGainCache(partitioned_hg);
+  moveAllNodesAtRandom();
+  gain_cache.reset();
+  gain_cache.initializeGainCache(partitioned_hg);
+  verifyGainCacheEntries();
+}
+
+using AKm1GainCacheWithLazyInitialization =
+  AGainCache<TestConfig<StaticHypergraphTypeTraits, Km1GainTypes, GainCacheFeature::lazy_initialization>>;
+
+TEST_F(AKm1GainCacheWithLazyInitialization, MaterializesInteriorNodesOnTheirFirstUpdate) {
+  initializePartition();
+  gain_cache.initializeGainCache(partitioned_hg);
+
+  // Only the entries of border nodes are initialized eagerly
+  HypernodeID interior_node = kInvalidHypernode;
+  HypernodeID neighbor = kInvalidHypernode;
+  for ( const HypernodeID& hn : partitioned_hg.nodes() ) {
+    ASSERT_EQ(partitioned_hg.isBorderNode(hn), gain_cache.isMaterialized(hn)) << V(hn);
+    if ( !partitioned_hg.isBorderNode(hn) && interior_node == kInvalidHypernode ) {
+      for ( const HyperedgeID& he : partitioned_hg.incidentEdges(hn) ) {
+        for ( const HypernodeID& pin : partitioned_hg.pins(he) ) {
+          if ( pin != hn ) {
+            interior_node = hn;
+            neighbor = pin;
+          }
+        }
+      }
+    }
+  }
+  ASSERT_NE(kInvalidHypernode, interior_node);
+
+  // Moving a neighbor into another block updates the benefit terms of the interior node
+  const PartitionID from = partitioned_hg.partID(neighbor);
+  const PartitionID to = ( from + 1 ) % k;
+  partitioned_hg.changeNodePart(gain_cache, neighbor, from, to);
+  gain_cache.recomputeInvalidTerms(partitioned_hg, neighbor);
+  ASSERT_TRUE(gain_cache.isMaterialized(interior_node));
+  for ( PartitionID block = 0; block < k; ++block ) {
+    ASSERT_EQ(gain_cache.recomputeBenefitTerm(partitioned_hg, interior_node, block),
+      gain_cache.benefitTerm(interior_node, block)) << V(block);
+  }
+}
+
+using AKm1GainCacheTrackingAdjacentBlocks =
+  AGainCache<TestConfig<StaticHypergraphTypeTraits, Km1GainTypes, GainCacheFeature::adjacent_blocks>>;
+
+TEST_F(AKm1GainCacheTrackingAdjacentBlocks, ContainsExactlyTheBlocksWithANonZeroBenefit) {
+  initializePartition();
+  gain_cache.initializeGainCache(partitioned_hg);
+  verifyAdjacentBlocksMatchBenefitTerms();
+}
+
+TEST_F(AKm1GainCacheTrackingAdjacentBlocks, ContainsExactlyTheBlocksWithANonZeroBenefitAfterConcurrentMoves) {
+  initializePartition();
+  gain_cache.initializeGainCache(partitioned_hg);
+  // Concurrent delta gain updates on the same node can temporarily
+  // make a benefit term negative, which must not corrupt the adjacent blocks
+  for ( size_t round = 0; round < 5; ++round ) {
+    moveAllNodesAtRandom();
+    verifyAdjacentBlocksMatchBenefitTerms();
+  }
+  verifyGainCacheEntries();
+}
+
 }
@@ -202,6 +202,24 @@ TEST_F(AKm1PolicyK4, ComputesCorrectMoveGainForVertex3) {
   ASSERT_EQ(0, move.gain);
 }
 
+TEST_F(AKm1PolicyK4, ComputesCorrectMoveGainIfLargeHyperedgesAreDeferred) {
+  gain->setHyperedgeSizeGainThreshold(2);
+  assignPartitionIDs({ 0, 2, 2, 0, 2, 1, 1 });
+  Move move = gain->computeMaxGainMove(hypergraph, 0);
+  ASSERT_EQ(0, move.from);
+  ASSERT_EQ(2, move.to);
+  ASSERT_EQ(-1, move.gain);
+}
+
+TEST_F(AKm1PolicyK4, ComputesCorrectMoveGainIfAllHyperedgesAreDeferred) {
+  gain->setHyperedgeSizeGainThreshold(2);
+  assignPartitionIDs({ 0, 3, 1, 2, 2, 0, 3 });
+  Move move = gain->computeMaxGainMove(hypergraph, 3);
+  ASSERT_EQ(2, move.from);
+  ASSERT_EQ(2, move.to);
+  ASSERT_EQ(0, move.gain);
+}
+
 using ACutPolicyK4 = AGainPolicy<CutGainComputation, 4>;
 
 TEST_F(ACutPolicyK4, ComputesCorrectMoveGainForVertex1) {
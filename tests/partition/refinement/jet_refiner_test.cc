@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * MIT License
+ *
+ * This file is part of Mt-KaHyPar.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************/
+
+#include "gmock/gmock.h"
+
+#include "tests/datastructures/hypergraph_fixtures.h"
+#include "mt-kahypar/definitions.h"
+#include "mt-kahypar/io/hypergraph_factory.h"
+#include "mt-kahypar/partition/context.h"
+#include "mt-kahypar/partition/initial_partitioning/bfs_initial_partitioner.h"
+#include "mt-kahypar/partition/refinement/jet/jet_refiner.h"
+#include "mt-kahypar/partition/refinement/gains/gain_definitions.h"
+#include "mt-kahypar/partition/refinement/rebalancing/advanced_rebalancer.h"
+#include "mt-kahypar/utils/cast.h"
+
+using ::testing::Test;
+
+namespace mt_kahypar {
+template <typename TypeTraitsT, PartitionID k, Objective objective>
+struct TestConfig { };
+
+template <typename TypeTraitsT, PartitionID k>
+struct TestConfig<TypeTraitsT, k, Objective::km1> {
+  using TypeTraits = TypeTraitsT;
+  using GainTypes = Km1GainTypes;
+  static constexpr PartitionID K = k;
+  static constexpr Objective OBJECTIVE = Objective::km1;
+};
+
+template <typename TypeTraitsT, PartitionID k>
+struct TestConfig<TypeTraitsT, k, Objective::cut> {
+  using TypeTraits = TypeTraitsT;
+  using GainTypes = CutGainTypes;
+  static constexpr PartitionID K = k;
+  static constexpr Objective OBJECTIVE = Objective::cut;
+};
+
+template <typename Config>
+class AJetRefiner : public Test {
+  static size_t num_threads;
+
+ public:
+  using TypeTraits = typename Config::TypeTraits;
+  using GainTypes = typename Config::GainTypes;
+  using Hypergraph = typename TypeTraits::Hypergraph;
+  using PartitionedHypergraph = typename TypeTraits::PartitionedHypergraph;
+  using GainCache = typename GainTypes::GainCache;
+  using Refiner = JetRefiner<GraphAndGainTypes<TypeTraits, GainTypes>>;
+
+  AJetRefiner() :
+    hypergraph(),
+    partitioned_hypergraph(),
+    context(),
+    gain_cache(),
+    refiner(nullptr),
+    metrics() {
+    context.partition.mode = Mode::direct;
+    context.partition.objective = Config::OBJECTIVE;
+    context.partition.gain_policy = context.partition.objective ==
+      Objective::km1 ? GainPolicy::km1 : GainPolicy::cut;
+    context.partition.epsilon = 0.03;
+    context.partition.k = Config::K;
+    context.partition.preset_type = PresetType::default_preset;
+    context.partition.instance_type = InstanceType::hypergraph;
+    context.partition.partition_type = PartitionedHypergraph::TYPE;
+    context.partition.verbose_output = false;
+
+    // Shared Memory
+    context.shared_memory.num_threads = num_threads;
+
+    // Initial Partitioning
+    context.initial_partitioning.mode = Mode::deep_multilevel;
+    context.initial_partitioning.runs = 1;
+
+    // Jet
+    context.refinement.label_propagation.algorithm = LabelPropagationAlgorithm::jet;
+    context.refinement.jet.num_iterations = 8;
+    context.refinement.jet.afterburner_he_size_threshold = 1000;
+
+    // Read hypergraph
+    hypergraph = io::readInputFile<Hypergraph>(
+      "../tests/instances/contracted_unweighted_ibm01.hgr", FileFormat::hMetis, true);
+    partitioned_hypergraph = PartitionedHypergraph(
+      context.partition.k, hypergraph, parallel_tag_t());
+    context.setupPartWeights(hypergraph.totalWeight());
+    initialPartition();
+
+    rebalancer = std::make_unique<AdvancedRebalancer<GraphAndGainTypes<TypeTraits, GainTypes>>>(
+      hypergraph.initialNumNodes(), context, gain_cache);
+    refiner = std::make_unique<Refiner>(
+      hypergraph.initialNumNodes(), hypergraph.initialNumEdges(), context, gain_cache, *rebalancer);
+    mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(partitioned_hypergraph);
+    rebalancer->initialize(phg);
+    refiner->initialize(phg);
+  }
+
+  void initialPartition() {
+    Context ip_context(context);
+    ip_context.refinement.label_propagation.algorithm = LabelPropagationAlgorithm::do_nothing;
+    InitialPartitioningDataContainer<TypeTraits> ip_data(partitioned_hypergraph, ip_context);
+    ip_data_container_t* ip_data_ptr = ip::to_pointer(ip_data);
+    BFSInitialPartitioner<TypeTraits> initial_partitioner(
+      InitialPartitioningAlgorithm::bfs, ip_data_ptr, ip_context, 420, 0);
+    initial_partitioner.partition();
+    ip_data.apply();
+    metrics.quality = metrics::quality(partitioned_hypergraph, context);
+    metrics.imbalance = metrics::imbalance(partitioned_hypergraph, context);
+  }
+
+  Hypergraph hypergraph;
+  PartitionedHypergraph partitioned_hypergraph;
+  Context context;
+  GainCache gain_cache;
+  std::unique_ptr<Refiner> refiner;
+  std::unique_ptr<IRebalancer> rebalancer;
+  Metrics metrics;
+};
+
+template <typename Config>
+size_t AJetRefiner<Config>::num_threads = HardwareTopology::instance().num_cpus();
+
+typedef ::testing::Types<TestConfig<StaticHypergraphTypeTraits, 2, Objective::cut>,
+                         TestConfig<StaticHypergraphTypeTraits, 4, Objective::cut>,
+                         TestConfig<StaticHypergraphTypeTraits, 8, Objective::cut>,
+                         TestConfig<StaticHypergraphTypeTraits, 2, Objective::km1>,
+                         TestConfig<StaticHypergraphTypeTraits, 4, Objective::km1>,
+                         TestConfig<StaticHypergraphTypeTraits, 8, Objective::km1> > TestConfigs;
+
+TYPED_TEST_CASE(AJetRefiner, TestConfigs);
+
+TYPED_TEST(AJetRefiner, UpdatesImbalanceCorrectly) {
+  mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(this->partitioned_hypergraph);
+  this->refiner->refine(phg, {}, this->metrics, std::numeric_limits<double>::max());
+  ASSERT_DOUBLE_EQ(metrics::imbalance(this->partitioned_hypergraph, this->context), this->metrics.imbalance);
+}
+
+TYPED_TEST(AJetRefiner, DoesNotWorsenBalance) {
+  const bool is_balanced = metrics::isBalanced(this->partitioned_hypergraph, this->context);
+  mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(this->partitioned_hypergraph);
+  this->refiner->refine(phg, {}, this->metrics, std::numeric_limits<double>::max());
+  if ( is_balanced ) {
+    ASSERT_TRUE(metrics::isBalanced(this->partitioned_hypergraph, this->context));
+  }
+}
+
+TYPED_TEST(AJetRefiner, UpdatesMetricsCorrectly) {
+  mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(this->partitioned_hypergraph);
+  this->refiner->refine(phg, {}, this->metrics, std::numeric_limits<double>::max());
+  ASSERT_EQ(metrics::quality(this->partitioned_hypergraph, this->context.partition.objective),
+            this->metrics.quality);
+}
+
+TYPED_TEST(AJetRefiner, DoesNotWorsenSolutionQuality) {
+  HyperedgeWeight objective_before = metrics::quality(this->partitioned_hypergraph, this->context.partition.objective);
+  mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(this->partitioned_hypergraph);
+  this->refiner->refine(phg, {}, this->metrics, std::numeric_limits<double>::max());
+  ASSERT_LE(this->metrics.quality, objective_before);
+}
+
+TYPED_TEST(AJetRefiner, KeepsGainCacheConsistent) {
+  mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(this->partitioned_hypergraph);
+  this->refiner->refine(phg, {}, this->metrics, std::numeric_limits<double>::max());
+  ASSERT_TRUE(this->partitioned_hypergraph.checkTrackedPartitionInformation(this->gain_cache));
+}
+
+}  // namespace mt_kahypar
@@ -212,6 +212,15 @@ TYPED_TEST(ALabelPropagationRefiner, DoesNotWorsenSolutionQuality) {
   ASSERT_LE(this->metrics.quality, objective_before);
 }
 
+TYPED_TEST(ALabelPropagationRefiner, DoesNotWorsenSolutionQualityWithGainBuckets) {
+  this->context.refinement.label_propagation.use_gain_buckets = true;
+  HyperedgeWeight objective_before = metrics::quality(this->partitioned_hypergraph, this->context.partition.objective);
+  mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(this->partitioned_hypergraph);
+  this->refiner->refine(phg, {}, this->metrics, std::numeric_limits<double>::max());
+  ASSERT_LE(this->metrics.quality, objective_before);
+  ASSERT_EQ(metrics::quality(this->partitioned_hypergraph, this->context.partition.objective),
+            this->metrics.quality);
+}
 
 TYPED_TEST(ALabelPropagationRefiner, ChangesTheNumberOfBlocks) {
   using PartitionedHypergraph = typename TestFixture::PartitionedHypergraph;
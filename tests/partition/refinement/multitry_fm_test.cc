@@ -35,6 +35,7 @@
 #include "mt-kahypar/partition/refinement/fm/strategies/gain_cache_strategy.h"
 #include "mt-kahypar/partition/initial_partitioning/bfs_initial_partitioner.h"
 #include "mt-kahypar/partition/refinement/rebalancing/advanced_rebalancer.h"
+#include "mt-kahypar/utils/exception.h"
 
 using ::testing::Test;
 
@@ -200,6 +201,23 @@ TYPED_TEST(MultiTryFMTest, AlsoWorksWithNonDefaultFeatures) {
   ASSERT_DOUBLE_EQ(metrics::imbalance(this->partitioned_hypergraph, this->context), this->metrics.imbalance);
 }
 
+TYPED_TEST(MultiTryFMTest, WorksWithAdaptiveEffort) {
+  this->context.refinement.fm.adaptive_effort = true;
+  this->context.refinement.fm.adaptive_effort_min_rate_fraction = 0.5;
+  this->context.refinement.fm.adaptive_effort_min_effort = 0.25;
+  HyperedgeWeight objective_before = metrics::quality(this->partitioned_hypergraph, this->context.partition.objective);
+  mt_kahypar_partitioned_hypergraph_t phg = utils::partitioned_hg_cast(this->partitioned_hypergraph);
+  // the second call uses the effort computed from the rate of the first call
+  for ( size_t level = 0; level < 2; ++level ) {
+    this->refiner->refine(phg, {}, this->metrics, std::numeric_limits<double>::max());
+    ASSERT_LE(this->metrics.quality, objective_before);
+    ASSERT_EQ(metrics::quality(this->partitioned_hypergraph, this->context.partition.objective),
+              this->metrics.quality);
+    ASSERT_LE(this->metrics.imbalance, this->context.partition.epsilon);
+    objective_before = this->metrics.quality;
+  }
+}
+
 TYPED_TEST(MultiTryFMTest, WorksWithRefinementNodes) {
   parallel::scalable_vector<HypernodeID> refinement_nodes;
   for (HypernodeID u = 0; u < this->partitioned_hypergraph.initialNumNodes(); ++u) {
@@ -253,6 +271,32 @@ TYPED_TEST(MultiTryFMTest, ChangesTheNumberOfBlocks) {
             this->metrics.quality);
 }
 
+TEST(MultiTryFMRoundTailCutoff, ComputesTheFinishedTasksLimit) {
+  using Refiner = MultiTryKWayFM<GraphAndGainTypes<StaticHypergraphTypeTraits, Km1GainTypes>>;
+  const size_t max_limit = std::numeric_limits<size_t>::max();
+  // no cutoff
+  ASSERT_EQ(max_limit, Refiner::finishedTasksLimit(1.0, 10, max_limit));
+  ASSERT_EQ(UL(8), Refiner::finishedTasksLimit(1.0, 10, 8));
+  // the limit is rounded up and at least one task must finish
+  ASSERT_EQ(UL(5), Refiner::finishedTasksLimit(0.5, 10, max_limit));
+  ASSERT_EQ(UL(3), Refiner::finishedTasksLimit(0.25, 10, max_limit));
+  ASSERT_EQ(UL(1), Refiner::finishedTasksLimit(0.01, 10, max_limit));
+  // the cutoff never increases the limit
+  ASSERT_EQ(UL(8), Refiner::finishedTasksLimit(0.5, 100, 8));
+}
+
+TEST(MultiTryFMRoundTailCutoff, IsRejectedOutsideOfTheUnitInterval) {
+  for ( const double cutoff : { 0.0, -0.5, 1.5 } ) {
+    Context context;
+    context.partition.mode = Mode::direct;
+    context.partition.k = 2;
+    context.partition.preset_type = PresetType::default_preset;
+    context.load_default_preset();
+    context.refinement.fm.round_tail_cutoff = cutoff;
+    ASSERT_THROW(context.sanityCheck(nullptr), InvalidParameterException);
+  }
+}
+
 TEST(UnconstrainedFMDataTest, CorrectlyComputesPenalty) {
   using TypeTraits = StaticHypergraphTypeTraits;
   using Hypergraph = typename TypeTraits::Hypergraph;
@@ -196,4 +196,200 @@ TEST_F(AProblemConstruction, GrowTwoFlowProblemAroundTwoBlocksSimultanously) {
   verifyThatVertexSetAreDisjoint(sub_hg_1, sub_hg_2);
 }
 
+TEST_F(AProblemConstruction, ResetsRegionGrowingStateBetweenTwoConstructions) {
+  ProblemConstruction<TypeTraits> constructor(
+    hg.initialNumNodes(), hg.initialNumEdges(), context);
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+  qg.initialize(phg);
+
+  max_part_weights.assign(context.partition.k, 400);
+  SearchID search_id = qg.requestNewSearch(refiner);
+  Subhypergraph sub_hg_1 = constructor.construct(search_id, qg, phg);
+  Subhypergraph sub_hg_2 = constructor.construct(search_id, qg, phg);
+  verifyThatPartWeightsAreLessEqualToMaxPartWeight(sub_hg_1, search_id, qg);
+  verifyThatPartWeightsAreLessEqualToMaxPartWeight(sub_hg_2, search_id, qg);
+
+  // The second construction must not see the visited nodes and
+  // hyperedges of the first one
+  ASSERT_GT(sub_hg_1.numNodes(), 0);
+  ASSERT_GT(sub_hg_2.numNodes(), 0);
+  std::set<HypernodeID> nodes;
+  for ( const HypernodeID& hn : sub_hg_2.nodes_of_block_0 ) {
+    ASSERT_TRUE(nodes.insert(hn).second);
+  }
+  for ( const HypernodeID& hn : sub_hg_2.nodes_of_block_1 ) {
+    ASSERT_TRUE(nodes.insert(hn).second);
+  }
+}
+
+TEST_F(AProblemConstruction, ComputesTheSameFingerprintForAnUnchangedRegion) {
+  context.refinement.flows.alpha = 1000;
+  context.refinement.flows.skip_unchanged_regions = true;
+  ProblemConstruction<TypeTraits> constructor(
+    hg.initialNumNodes(), hg.initialNumEdges(), context);
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+  qg.initialize(phg);
+
+  SearchID search_id = qg.requestNewSearch(refiner);
+  Subhypergraph sub_hg_1 = constructor.construct(search_id, qg, phg);
+  Subhypergraph sub_hg_2 = constructor.construct(search_id, qg, phg);
+  ASSERT_NE(0, sub_hg_1.fingerprint);
+  ASSERT_EQ(sub_hg_1.fingerprint, sub_hg_2.fingerprint);
+
+  qg.setUnsuccessfulRegion(search_id, sub_hg_1.fingerprint);
+  ASSERT_TRUE(qg.isUnsuccessfulRegion(search_id, sub_hg_2.fingerprint));
+
+  // Moving a node of the region changes the fingerprint
+  ASSERT_GT(sub_hg_1.nodes_of_block_0.size(), 0);
+  const HypernodeID hn = sub_hg_1.nodes_of_block_0[0];
+  phg.changeNodePart(hn, sub_hg_1.block_0, sub_hg_1.block_1);
+  Subhypergraph sub_hg_3 = constructor.construct(search_id, qg, phg);
+  ASSERT_NE(sub_hg_1.fingerprint, sub_hg_3.fingerprint);
+  ASSERT_FALSE(qg.isUnsuccessfulRegion(search_id, sub_hg_3.fingerprint));
+}
+
+TEST_F(AProblemConstruction, FingerprintChangesIfPartWeightsChange) {
+  context.refinement.flows.skip_unchanged_regions = true;
+  ProblemConstruction<TypeTraits> constructor(
+    hg.initialNumNodes(), hg.initialNumEdges(), context);
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+  qg.initialize(phg);
+
+  SearchID search_id = qg.requestNewSearch(refiner);
+  Subhypergraph sub_hg_1 = constructor.construct(search_id, qg, phg);
+
+  // Move a node of the first block that is not adjacent to the region to a third block
+  std::set<HypernodeID> region_nodes(sub_hg_1.nodes_of_block_0.begin(), sub_hg_1.nodes_of_block_0.end());
+  std::set<HyperedgeID> region_hes(sub_hg_1.hes.begin(), sub_hg_1.hes.end());
+  HypernodeID hn = kInvalidHypernode;
+  for ( HypernodeID u = 0; u < phg.initialNumNodes() && hn == kInvalidHypernode; ++u ) {
+    if ( phg.partID(u) == sub_hg_1.block_0 && region_nodes.count(u) == 0 ) {
+      bool is_adjacent = false;
+      for ( const HyperedgeID& he : phg.incidentEdges(u) ) {
+        is_adjacent |= region_hes.count(he) > 0;
+      }
+      hn = is_adjacent ? kInvalidHypernode : u;
+    }
+  }
+  ASSERT_NE(kInvalidHypernode, hn);
+  PartitionID to = 0;
+  while ( to == sub_hg_1.block_0 || to == sub_hg_1.block_1 ) ++to;
+  phg.changeNodePart(hn, sub_hg_1.block_0, to);
+
+  Subhypergraph sub_hg_2 = constructor.construct(search_id, qg, phg);
+  ASSERT_NE(sub_hg_1.fingerprint, sub_hg_2.fingerprint);
+}
+
+TEST_F(AProblemConstruction, GrowsDisjointRegionsIfNodesHaveAnOwner) {
+  context.refinement.flows.alpha = 1000;
+  context.refinement.flows.disjoint_regions = true;
+  ProblemConstruction<TypeTraits> constructor(
+    hg.initialNumNodes(), hg.initialNumEdges(), context);
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+  qg.initialize(phg);
+
+  SearchID search_id_1 = qg.requestNewSearch(refiner);
+  Subhypergraph sub_hg_1 = constructor.construct(search_id_1, qg, phg);
+  qg.finalizeConstruction(search_id_1);
+  SearchID search_id_2 = qg.requestNewSearch(refiner);
+  Subhypergraph sub_hg_2 = constructor.construct(search_id_2, qg, phg);
+  verifyThatVertexSetAreDisjoint(sub_hg_1, sub_hg_2);
+
+  // After releasing its nodes, the first search can grow its region
+  // again, but still not on the nodes of the second search
+  constructor.releaseNodes(search_id_1, sub_hg_1);
+  Subhypergraph sub_hg_3 = constructor.construct(search_id_1, qg, phg);
+  ASSERT_GT(sub_hg_3.numNodes(), 0);
+  verifyThatVertexSetAreDisjoint(sub_hg_3, sub_hg_2);
+}
+
+TEST_F(AProblemConstruction, ShrinksARegionToTheNodesClosestToTheCut) {
+  context.refinement.flows.alpha = 1000;
+  ProblemConstruction<TypeTraits> constructor(
+    hg.initialNumNodes(), hg.initialNumEdges(), context);
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+  qg.initialize(phg);
+
+  SearchID search_id = qg.requestNewSearch(refiner);
+  Subhypergraph sub_hg = constructor.construct(search_id, qg, phg);
+  Subhypergraph shrunk_hg = constructor.shrinkRegion(phg, sub_hg, 0.5);
+  ASSERT_GT(shrunk_hg.numNodes(), 0);
+  ASSERT_LT(shrunk_hg.numNodes(), sub_hg.numNodes());
+  ASSERT_LT(shrunk_hg.num_pins, sub_hg.num_pins);
+
+  // The shrunk region is a prefix of the BFS order of each block
+  for ( size_t i = 0; i < shrunk_hg.nodes_of_block_0.size(); ++i ) {
+    ASSERT_EQ(sub_hg.nodes_of_block_0[i], shrunk_hg.nodes_of_block_0[i]);
+  }
+  for ( size_t i = 0; i < shrunk_hg.nodes_of_block_1.size(); ++i ) {
+    ASSERT_EQ(sub_hg.nodes_of_block_1[i], shrunk_hg.nodes_of_block_1[i]);
+  }
+
+  // All hyperedges incident to the nodes of the shrunk region are contained
+  std::set<HyperedgeID> hes(shrunk_hg.hes.begin(), shrunk_hg.hes.end());
+  ASSERT_EQ(shrunk_hg.hes.size(), hes.size());
+  for ( const HypernodeID& hn : shrunk_hg.nodes_of_block_0 ) {
+    for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+      ASSERT_TRUE(hes.count(he) > 0);
+    }
+  }
+  for ( const HypernodeID& hn : shrunk_hg.nodes_of_block_1 ) {
+    for ( const HyperedgeID& he : phg.incidentEdges(hn) ) {
+      ASSERT_TRUE(hes.count(he) > 0);
+    }
+  }
+}
+
+TEST_F(AProblemConstruction, ExtractsAllBlockPairsOfAMultiwayRegion) {
+  context.refinement.flows.alpha = 1000;
+  context.refinement.flows.max_blocks_per_region = 4;
+  ProblemConstruction<TypeTraits> constructor(
+    hg.initialNumNodes(), hg.initialNumEdges(), context);
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+  qg.initialize(phg);
+
+  SearchID search_id = qg.requestNewSearch(refiner);
+  const BlockPair blocks = qg.getBlockPair(search_id);
+  MultiwayRegion region = constructor.constructMultiwayRegion(search_id, qg, phg);
+  ASSERT_EQ(UL(4), region.blocks.size());
+  ASSERT_EQ(blocks.i, region.blocks[0]);
+  ASSERT_EQ(blocks.j, region.blocks[1]);
+  ASSERT_GT(region.numNodes(), 0);
+
+  // All nodes of the region are assigned to one of its blocks
+  std::set<PartitionID> region_blocks(region.blocks.begin(), region.blocks.end());
+  for ( const HypernodeID& hn : region.nodes ) {
+    ASSERT_TRUE(region_blocks.count(phg.partID(hn)) > 0);
+  }
+  size_t num_nodes = 0;
+  for ( size_t i = 0; i < region.blocks.size(); ++i ) {
+    for ( size_t j = i + 1; j < region.blocks.size(); ++j ) {
+      const PartitionID block_0 = std::min(region.blocks[i], region.blocks[j]);
+      const PartitionID block_1 = std::max(region.blocks[i], region.blocks[j]);
+      Subhypergraph sub_hg = constructor.extractBlockPair(phg, region, block_0, block_1);
+      for ( const HypernodeID& hn : sub_hg.nodes_of_block_0 ) {
+        ASSERT_EQ(block_0, phg.partID(hn));
+      }
+      for ( const HypernodeID& hn : sub_hg.nodes_of_block_1 ) {
+        ASSERT_EQ(block_1, phg.partID(hn));
+      }
+      num_nodes += sub_hg.numNodes();
+    }
+  }
+  // Every node is part of (#blocks - 1) block pairs
+  ASSERT_EQ(region.numNodes() * ( region.blocks.size() - 1 ), num_nodes);
+}
+
 }
\ No newline at end of file
@@ -26,6 +26,8 @@
 
 #include "gmock/gmock.h"
 
+#include "mt-kahypar/definitions.h"
+#include "mt-kahypar/io/hypergraph_factory.h"
 #include "mt-kahypar/io/hypergraph_io.h"
 #include "mt-kahypar/partition/refinement/flows/quotient_graph.h"
 #include "tests/partition/refinement/flow_refiner_mock.h"
@@ -193,4 +195,190 @@ TEST_F(AQuotientGraph, SimulatesBlockSchedulingWithSuccessfulSearches) {
   }
 }*/
 
+namespace {
+  using TypeTraits = StaticHypergraphTypeTraits;
+  using Hypergraph = typename TypeTraits::Hypergraph;
+  using PartitionedHypergraph = typename TypeTraits::PartitionedHypergraph;
+}
+
+class ABlockPairSchedule : public Test {
+ public:
+  ABlockPairSchedule() :
+    hg(),
+    phg(),
+    context() {
+
+    context.partition.graph_filename = "../tests/instances/ibm01.hgr";
+    context.partition.k = 8;
+    context.partition.epsilon = 0.03;
+    context.partition.mode = Mode::direct;
+    context.partition.objective = Objective::km1;
+    context.shared_memory.num_threads = std::thread::hardware_concurrency();
+    context.refinement.flows.algorithm = FlowAlgorithm::mock;
+
+    // Read hypergraph
+    hg = io::readInputFile<Hypergraph>(
+      context.partition.graph_filename, FileFormat::hMetis, true);
+    phg = PartitionedHypergraph(
+      context.partition.k, hg, parallel_tag_t());
+    context.setupPartWeights(hg.totalWeight());
+
+    // Read Partition
+    std::vector<PartitionID> partition;
+    io::readPartitionFile("../tests/instances/ibm01.hgr.part8", partition);
+    phg.doParallelForAllNodes([&](const HypernodeID& hn) {
+      phg.setOnlyNodePart(hn, partition[hn]);
+    });
+    phg.initializePartition();
+
+    FlowRefinerMockControl::instance().reset();
+  }
+
+  // ! Searches all block pairs of one round sequentially without finding an
+  // ! improvement. The callback is invoked after each search is finalized.
+  template<typename F>
+  size_t runRound(QuotientGraph<TypeTraits>& qg,
+                  FlowRefinerAdapter<TypeTraits>& refiner,
+                  const F& f) {
+    qg.initialize(phg);
+    size_t num_searches = 0;
+    SearchID search_id = qg.requestNewSearch(refiner);
+    while ( search_id != QuotientGraph<TypeTraits>::INVALID_SEARCH_ID ) {
+      const BlockPair blocks = qg.getBlockPair(search_id);
+      qg.finalizeConstruction(search_id);
+      refiner.finalizeSearch(search_id);
+      f(search_id, blocks);
+      ++num_searches;
+      search_id = qg.requestNewSearch(refiner);
+    }
+    return num_searches;
+  }
+
+  Hypergraph hg;
+  PartitionedHypergraph phg;
+  Context context;
+};
+
+TEST_F(ABlockPairSchedule, SchedulesUnexploredBlockPairsByCutWeight) {
+  context.refinement.flows.prioritize_block_pairs = true;
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+
+  vec<HyperedgeWeight> cut_weights;
+  runRound(qg, refiner, [&](const SearchID search_id, const BlockPair& blocks) {
+    cut_weights.push_back(qg.getCutHyperedgeWeightOfBlockPair(blocks.i, blocks.j));
+    qg.finalizeSearch(search_id, 0, 0.1);
+  });
+
+  ASSERT_GT(cut_weights.size(), UL(1));
+  for ( size_t i = 1; i < cut_weights.size(); ++i ) {
+    ASSERT_GE(cut_weights[i - 1], cut_weights[i]);
+  }
+}
+
+TEST_F(ABlockPairSchedule, SchedulesExploredBlockPairsByExpectedImprovementPerSecond) {
+  context.refinement.flows.prioritize_block_pairs = true;
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+
+  // Running times are multiples of 1/64 seconds such that they convert
+  // exactly to microseconds
+  auto running_time = [&](const BlockPair& blocks) {
+    return ( 1 + ( blocks.i + blocks.j ) % 4 ) / 64.0;
+  };
+  const size_t num_block_pairs = runRound(qg, refiner,
+    [&](const SearchID search_id, const BlockPair& blocks) {
+      qg.finalizeSearch(search_id, 0, running_time(blocks));
+    });
+  ASSERT_GT(num_block_pairs, UL(1));
+
+  // Without improvements, the expected improvement per second of a block pair
+  // searched once is half of its cut weight divided by its running time
+  vec<double> expected_improvements;
+  ASSERT_EQ(num_block_pairs, runRound(qg, refiner,
+    [&](const SearchID search_id, const BlockPair& blocks) {
+      expected_improvements.push_back(qg.getCutHyperedgeWeightOfBlockPair(
+        blocks.i, blocks.j) / ( 2.0 * running_time(blocks) ));
+      qg.finalizeSearch(search_id, 0, running_time(blocks));
+    }));
+
+  for ( size_t i = 1; i < expected_improvements.size(); ++i ) {
+    ASSERT_GE(expected_improvements[i - 1], expected_improvements[i]);
+  }
+}
+
+TEST_F(ABlockPairSchedule, DetectsHopelessBlockPairs) {
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+
+  // A single unsuccessful search is not enough to give up on a block pair
+  runRound(qg, refiner, [&](const SearchID search_id, const BlockPair&) {
+    qg.finalizeSearch(search_id, 0, 0.1);
+    ASSERT_FALSE(qg.isHopelessBlockPair(search_id));
+  });
+
+  // After the second unsuccessful search, all block pairs are hopeless
+  runRound(qg, refiner, [&](const SearchID search_id, const BlockPair&) {
+    qg.finalizeSearch(search_id, 0, 0.1);
+    ASSERT_TRUE(qg.isHopelessBlockPair(search_id));
+  });
+}
+
+TEST_F(ABlockPairSchedule, DoesNotConsiderBlockPairsWithAnImprovementAsHopeless) {
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+
+  // The first block pair of the first round finds an improvement
+  bool is_first_search = true;
+  BlockPair improved_blocks;
+  runRound(qg, refiner, [&](const SearchID search_id, const BlockPair& blocks) {
+    if ( is_first_search ) {
+      improved_blocks = blocks;
+      is_first_search = false;
+      qg.finalizeSearch(search_id, 1, 0.1);
+    } else {
+      qg.finalizeSearch(search_id, 0, 0.1);
+    }
+  });
+
+  size_t num_hopeless_block_pairs = 0;
+  runRound(qg, refiner, [&](const SearchID search_id, const BlockPair& blocks) {
+    qg.finalizeSearch(search_id, 0, 0.1);
+    if ( blocks.i == improved_blocks.i && blocks.j == improved_blocks.j ) {
+      ASSERT_FALSE(qg.isHopelessBlockPair(search_id));
+    } else if ( qg.isHopelessBlockPair(search_id) ) {
+      ++num_hopeless_block_pairs;
+    }
+  });
+  ASSERT_GT(num_hopeless_block_pairs, UL(0));
+}
+
+TEST_F(ABlockPairSchedule, SkipsBlockPairsWithALowPredictedSuccessProbability) {
+  context.refinement.flows.predictor_threshold = 0.4;
+  FlowRefinerAdapter<TypeTraits> refiner(hg.initialNumEdges(), context);
+  QuotientGraph<TypeTraits> qg(hg.initialNumEdges(), context);
+  refiner.initialize(context.shared_memory.num_threads);
+
+  // Each round searches all block pairs without finding an improvement
+  auto run_round = [&] {
+    return runRound(qg, refiner, [&](const SearchID search_id, const BlockPair&) {
+      qg.finalizeSearch(search_id, 0, 0.1);
+    });
+  };
+
+  // Success probability is 1.0 and 0.5 for the first two rounds and 0.33 afterwards
+  const size_t num_block_pairs = run_round();
+  ASSERT_GT(num_block_pairs, UL(0));
+  ASSERT_EQ(UL(0), qg.numPredictedSkips());
+  ASSERT_EQ(num_block_pairs, run_round());
+  ASSERT_EQ(UL(0), qg.numPredictedSkips());
+  ASSERT_EQ(UL(0), run_round());
+  ASSERT_EQ(num_block_pairs, qg.numPredictedSkips());
+  ASSERT_GT(qg.predictedTimeSaved(), 0.0);
+}
+
 }
\ No newline at end of file